@@ -0,0 +1,85 @@
+// ikun库high_precision_digit.hpp加减法和比较内核的性能测试程序
+// 对1000~1000000个单元的大数, 分别在标量/AVX2/AVX-512级别下测量+=, -=和比较的耗时
+// 结果输出到控制台, 并写入当前目录下的bench_output.txt; CPU不支持的级别会跳过
+// 编译示例: g++ -std=c++23 -O3 bench_simd.cpp -o bench_simd
+
+// 本库开源GitHub地址: https://github.com/0kunkun0/ikun
+// 下载本库开源完整版: git clone https://github.com/0kunkun0/ikun.git
+// 仅供个人, 非营利性组织, 开源项目以及竞赛使用
+// 遵循GPL 3.0许可证, 禁止使用本库进行闭源用途
+
+#if __has_include("high_precision_digit.hpp")
+#include "high_precision_digit.hpp"
+#else
+#error "当前目录不存在high_precision_digit.hpp"
+#endif
+
+#include <chrono>
+#include <random>
+
+namespace hpd = high_precision_digit;
+
+// 每种规模的总工作量约为该单元数, 小规模时重复更多次, 使各规模的计时时长相近
+const size_t WORK_PER_TEST = 200000000;
+
+const char* level_name(hpd::simd_level level)
+{
+    switch (level)
+    {
+        case hpd::simd_level::avx2: return "avx2";
+        case hpd::simd_level::avx512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+hpd::bigint random_bigint(size_t limbs, std::mt19937& gen)
+{
+    std::uniform_int_distribution<int> dist(0, 999999999);
+    std::vector<int> digits(limbs);
+    for (int& d : digits) d = dist(gen);
+    digits.back() = std::max(digits.back(), 1);
+    return hpd::bigint::from_limbs(digits);
+}
+
+// 运行fn()共reps次, 返回平均每个单元的耗时(纳秒)
+template <typename F>
+double ns_per_limb(size_t limbs, size_t reps, F fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < reps; ++ i) fn();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(reps * limbs);
+}
+
+int main()
+{
+    std::mt19937 gen(20260124);
+    std::string report = std::format("{:>8} {:>7} {:>10} {:>10} {:>10}   (ns/单元)\n", "单元数", "指令集", "+=", "-=", "比较");
+    volatile bool sink = false;
+
+    for (size_t limbs : {1000, 10000, 100000, 1000000})
+    {
+        hpd::bigint a = random_bigint(limbs, gen);
+        hpd::bigint b = a + 1; // 只有最低位不同, 比较时要扫描全部单元
+        size_t reps = std::max<size_t>(1, WORK_PER_TEST / limbs);
+
+        for (hpd::simd_level level : {hpd::simd_level::scalar, hpd::simd_level::avx2, hpd::simd_level::avx512})
+        {
+            hpd::bigint::set_simd_level(level);
+            if (hpd::bigint::get_simd_level() != level) continue;
+
+            // 先加reps次再减reps次, x回到a, 规模最多增加一个单元
+            hpd::bigint x = a;
+            double add = ns_per_limb(limbs, reps, [&] { x += b; });
+            double sub = ns_per_limb(limbs, reps, [&] { x -= b; });
+            double cmp = ns_per_limb(limbs, reps, [&] { sink = a < b; });
+            if (x != a) std::println("结果错误: {}个单元, {}", limbs, level_name(level));
+
+            report += std::format("{:>8} {:>7} {:>10.3f} {:>10.3f} {:>10.3f}\n", limbs, level_name(level), add, sub, cmp);
+        }
+    }
+
+    std::print("{}", report);
+    std::ofstream("bench_output.txt") << report;
+    return 0;
+}
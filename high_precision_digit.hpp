@@ -9,9 +9,12 @@
 // 性能提示：
 // 1. 对于小数字(< 2^63)，直接使用 long long 可能更快
 // 2. 频繁的字符串转换会影响性能
-// 3. 除法是最慢的操作，尽量避免
-// 4. Karatsuba乘法在数字位数 > 64时自动启用
+// 3. 除法是最慢的操作，尽量避免 (除数超过240个单元时自动使用Burnikel-Ziegler递归除法)
+// 4. 乘法按规模自动选择朴素/Karatsuba/Toom-3/Toom-4/NTT算法, 超过1536个单元(约13800位十进制)时使用三模数NTT乘法
 // 5. 使用移动语义避免不必要的拷贝
+// 6. 对同一个模数反复做模乘/模幂时使用mod_ctx, 内层循环不做除法
+// 7. 计算密集且很少输出的场景可以使用binary_bigint(2^64进制), 只在输入输出时做进制转换
+// 8. 保存和读取大量大数时使用bigint_archive(二进制格式, 读取时内存映射), 不做十进制转换
 
 // 本库开源GitHub地址: https://github.com/0kunkun0/ikun
 // 下载本库开源完整版: git clone https://github.com/0kunkun0/ikun.git
@@ -25,1052 +28,4952 @@
 #include <format>
 #include <string>
 #include <vector>
+#include <utility>
 #include <algorithm>
 #include <cmath>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <bit>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <deque>
+#include <exception>
+#include <concepts>
+#include <memory_resource>
+#include <span>
+#include <fstream>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX // windows.h的min/max宏会破坏std::min/std::max和numeric_limits<T>::max()
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// x86-64下加减法和比较使用AVX2/AVX-512内核, 运行时按CPU支持情况选择; 定义IKUN_HPD_NO_SIMD可关闭
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(IKUN_HPD_NO_SIMD)
+#define IKUN_HPD_X86_SIMD
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define IKUN_HPD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define IKUN_HPD_TARGET(isa)
+#endif
+#endif
 #include "console_color.hpp"
 #include "ikun_stderr.hpp"
 
 namespace high_precision_digit
 {
     using namespace ikun_error; // ikun库错误抛出函数
+
+    // 加减法和比较内核使用的指令集级别
+    enum class simd_level
+    {
+        scalar,  // 普通标量循环
+        avx2,    // 每次处理8个单元
+        avx512   // 每次处理16个单元
+    };
+
+    // 大数的单元存储, 接口与std::vector<int>相同
+    // 不超过INLINE_CAPACITY个单元时直接存放在对象内部, 超出后才从内存资源(std::pmr::memory_resource)申请
+    // 内存资源在构造时确定: 复制构造使用当前资源, 移动构造沿用源对象的资源, 赋值不改变自身的资源(与std::pmr容器相同)
+    class limb_vector
+    {
+    public:
+        static const size_t INLINE_CAPACITY = 4; // 内联单元数, 可容纳小于10^36的数(包括所有64位整数)
+
+        // 当前线程新建存储使用的内存资源, 为空时使用std::pmr的默认资源(见bigint::memory_scope)
+        static std::pmr::memory_resource*& scoped_resource() noexcept
+        {
+            static thread_local std::pmr::memory_resource* resource = nullptr;
+            return resource;
+        }
+
+        static std::pmr::memory_resource* current_resource() noexcept
+        {
+            std::pmr::memory_resource* resource = scoped_resource();
+            return resource ? resource : std::pmr::get_default_resource();
+        }
+
+        limb_vector() noexcept : limb_vector(current_resource()) {}
+
+        explicit limb_vector(std::pmr::memory_resource* resource) noexcept
+            : ptr(local), len(0), cap(INLINE_CAPACITY), res(resource) {}
+
+        limb_vector(size_t n, int value) : limb_vector()
+        {
+            assign(n, value);
+        }
+
+        limb_vector(const int* first, const int* last) : limb_vector()
+        {
+            assign(first, last);
+        }
+
+        limb_vector(const limb_vector& other) : limb_vector()
+        {
+            assign(other.begin(), other.end());
+        }
+
+        limb_vector(limb_vector&& other) noexcept : limb_vector(other.res)
+        {
+            steal(other);
+        }
+
+        ~limb_vector()
+        {
+            release();
+        }
+
+        limb_vector& operator=(const limb_vector& other)
+        {
+            if (this != &other) assign(other.begin(), other.end());
+            return *this;
+        }
+
+        // 两者的内存资源不同时只能复制内容, 以免自身持有别的资源上的内存
+        // 复制要在自身的资源上申请内存, 可能抛出异常, 所以与std::pmr::vector一样不声明noexcept
+        // 资源相同或other的单元在内联存储中时不申请内存, 不会抛出异常
+        limb_vector& operator=(limb_vector&& other)
+        {
+            if (this == &other) return *this;
+            if (other.is_inline() || !same_resource(other))
+            {
+                assign(other.begin(), other.end());
+                other.clear();
+                return *this;
+            }
+            release();
+            ptr = local;
+            cap = INLINE_CAPACITY;
+            steal(other);
+            return *this;
+        }
+
+        size_t size() const noexcept { return len; }
+        size_t capacity() const noexcept { return cap; }
+        bool empty() const noexcept { return len == 0; }
+        bool is_inline() const noexcept { return ptr == local; } // 是否没有占用堆内存
+        std::pmr::memory_resource* resource() const noexcept { return res; }
+        bool same_resource(const limb_vector& other) const noexcept
+        {
+            return res == other.res || res->is_equal(*other.res);
+        }
+
+        int* data() noexcept { return ptr; }
+        const int* data() const noexcept { return ptr; }
+        int* begin() noexcept { return ptr; }
+        const int* begin() const noexcept { return ptr; }
+        int* end() noexcept { return ptr + len; }
+        const int* end() const noexcept { return ptr + len; }
+        int& operator[](size_t i) noexcept { return ptr[i]; }
+        const int& operator[](size_t i) const noexcept { return ptr[i]; }
+        int& back() noexcept { return ptr[len - 1]; }
+        const int& back() const noexcept { return ptr[len - 1]; }
+
+        void reserve(size_t n)
+        {
+            if (n > cap) reallocate(std::max(n, cap * 2));
+        }
+
+        void resize(size_t n, int value = 0)
+        {
+            reserve(n);
+            if (n > len) std::fill(ptr + len, ptr + n, value);
+            len = n;
+        }
+
+        void assign(size_t n, int value)
+        {
+            len = 0; // 旧内容不需要保留, 扩容时不必复制
+            resize(n, value);
+        }
+
+        void assign(const int* first, const int* last)
+        {
+            size_t n = static_cast<size_t>(last - first);
+            if (n > cap)
+            {
+                len = 0;
+                reserve(n);
+            }
+            std::memmove(ptr, first, n * sizeof(int)); // 允许源区间位于自身内部
+            len = n;
+        }
+
+        void push_back(int value)
+        {
+            if (len == cap) reallocate(cap * 2);
+            ptr[len ++] = value;
+        }
+
+        void pop_back() noexcept { -- len; }
+        void clear() noexcept { len = 0; }
+
+        // 把容量缩小到单元数, 放得下时回到内联存储
+        void shrink_to_fit()
+        {
+            if (is_inline() || cap == len) return;
+            if (len > INLINE_CAPACITY)
+            {
+                reallocate(len);
+                return;
+            }
+            int* old = ptr;
+            size_t old_cap = cap;
+            std::memcpy(local, old, len * sizeof(int));
+            ptr = local;
+            cap = INLINE_CAPACITY;
+            res->deallocate(old, old_cap * sizeof(int), alignof(int));
+        }
+
+        // 在pos前插入count个value
+        void insert(int* pos, size_t count, int value)
+        {
+            size_t offset = static_cast<size_t>(pos - ptr);
+            size_t old_len = len;
+            resize(len + count);
+            std::memmove(ptr + offset + count, ptr + offset, (old_len - offset) * sizeof(int));
+            std::fill(ptr + offset, ptr + offset + count, value);
+        }
+
+        bool operator==(const limb_vector& other) const noexcept
+        {
+            return len == other.len && std::equal(begin(), end(), other.begin());
+        }
+
+        bool operator!=(const limb_vector& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        int* ptr;                    // 当前存储位置(local或堆内存)
+        size_t len;                  // 单元数
+        size_t cap;                  // 容量
+        int local[INLINE_CAPACITY];  // 内联存储
+        std::pmr::memory_resource* res; // 超出内联容量时申请内存的资源
+
+        void reallocate(size_t n)
+        {
+            int* p = static_cast<int*>(res->allocate(n * sizeof(int), alignof(int)));
+            std::memcpy(p, ptr, len * sizeof(int));
+            release();
+            ptr = p;
+            cap = n;
+        }
+
+        void release() noexcept
+        {
+            if (!is_inline()) res->deallocate(ptr, cap * sizeof(int), alignof(int));
+        }
+
+        // 接管other的内容, other变为空的内联状态(要求自身为空的内联状态, 且与other使用相同的内存资源)
+        void steal(limb_vector& other) noexcept
+        {
+            if (other.is_inline())
+            {
+                std::memcpy(local, other.local, other.len * sizeof(int));
+            }
+            else
+            {
+                ptr = other.ptr;
+                cap = other.cap;
+                other.ptr = other.local;
+                other.cap = INLINE_CAPACITY;
+            }
+            len = other.len;
+            other.len = 0;
+        }
+    };
+
+    class mod_ctx;
+    class bigint;
+
+    // 惰性大数表达式(见mul()): accumulate(x, negate)把表达式的值(negate为true时取相反数)累加到x上
+    // refers_to(p)表示表达式是否引用了p指向的大数, 目标与操作数重叠时要先求值到临时对象
+    template <typename T>
+    concept bigint_expression = requires(const T& e, bigint& x, const bigint* p)
+    {
+        e.accumulate(x, false);
+        { e.refers_to(p) } -> std::convertible_to<bool>;
+    };
+
     class bigint // 大数类
     {
+        friend class mod_ctx; // 模运算上下文直接按单元截取和移位
+        
     private:
         static const int BASE = 1000000000;      // 10亿进制
         static const int BASE_DIGITS = 9;        // 每个单元的数字位数
+        // 乘法算法切换阈值(单元数, 取两个乘数中较短的一方比较), 均为实测的交叉点
+        // NTT的变换长度按2的幂增长, 耗时呈阶梯状, 1024~1536个单元时Toom-4比Toom-3和NTT都快
+        static const size_t KARATSUBA_THRESHOLD = 64;  // 超过该单元数时使用Karatsuba乘法
+        static const size_t TOOM3_THRESHOLD = 640;     // 超过该单元数时使用Toom-3乘法
+        static const size_t TOOM4_THRESHOLD = 1024;    // 超过该单元数时使用Toom-4乘法
+        static const size_t NTT_THRESHOLD = 1536;      // 超过该单元数时使用三模数NTT乘法
+        static const size_t BZ_THRESHOLD = 240;        // 除数和商都超过该单元数时使用Burnikel-Ziegler递归除法
+        static constexpr int WORD_SHIFT = 29;          // 单元级移位每次最多移动的位数(2^29 < BASE)
+        static const size_t PARALLEL_THRESHOLD = 32768; // NTT变换长度超过该值时使用多线程
+        static const size_t SCRATCH_KEEP_LIMIT = 65536; // 线程局部缓冲区的容量超过该单元数(256KB)时用完即释放
+        static constexpr int SHIFT_WORDS = 4;          // 位移不超过该组数时逐单元移位, 否则一次乘除2的幂
         
-        std::vector<int> digits;  // 存储数字，低位在前
+        limb_vector digits;       // 存储数字，低位在前(较小的数不占用堆内存), 零的单元为空
         bool is_negative;         // 是否为负数
         
-        // 移除前导零
+        // 移除前导零, 零的单元全部移除
         void trim() noexcept
         {
-            while (digits.size() > 1 && digits.back() == 0)
+            while (!digits.empty() && digits.back() == 0)
             {
                 digits.pop_back();
             }
-            if (digits.size() == 1 && digits[0] == 0)
+            if (digits.empty())
             {
                 is_negative = false;
             }
         }
         
-        // 比较绝对值大小
-        int compare_abs(const bigint& other) const noexcept
+        // 单元数组的加减法和比较内核: out[0, n) = a + b + carry 或 a - b - borrow, 返回最高位的进位/借位, out可以与a或b相同
+        // 向量版本先逐单元求和, 再由"产生进位"(和 >= BASE)与"传递进位"(和 == BASE - 1)两个位掩码
+        // 通过一次整数加法求出每个单元收到的进位: C = ((G << 1 | cin) + P) ^ P, 整个过程没有依赖数据的分支
+        static int add_n_scalar(const int* a, const int* b, int* out, size_t n, int carry) noexcept
         {
-            if (digits.size() != other.digits.size())
+            for (size_t i = 0; i < n; ++ i)
             {
-                return digits.size() > other.digits.size() ? 1 : -1;
+                int sum = a[i] + b[i] + carry;
+                carry = sum >= BASE;
+                out[i] = carry ? sum - BASE : sum;
             }
-            for (int i = static_cast<int>(digits.size()) - 1; i >= 0; -- i)
+            return carry;
+        }
+
+        static int sub_n_scalar(const int* a, const int* b, int* out, size_t n, int borrow) noexcept
+        {
+            for (size_t i = 0; i < n; ++ i)
             {
-                if (digits[i] != other.digits[i])
-                {
-                    return digits[i] > other.digits[i] ? 1 : -1;
-                }
+                int diff = a[i] - b[i] - borrow;
+                borrow = diff < 0;
+                out[i] = borrow ? diff + BASE : diff;
+            }
+            return borrow;
+        }
+
+        static int compare_n_scalar(const int* a, const int* b, size_t n) noexcept
+        {
+            for (size_t i = n; i -- > 0; )
+            {
+                if (a[i] != b[i]) return a[i] > b[i] ? 1 : -1;
             }
             return 0;
         }
-        
-        // 加法辅助函数
-        static void add_abs(const bigint& a, const bigint& b, bigint& result) noexcept
+
+#ifdef IKUN_HPD_X86_SIMD
+        IKUN_HPD_TARGET("avx2")
+        static int add_n_avx2(const int* a, const int* b, int* out, size_t n, int carry) noexcept
         {
-            result.digits.clear();
-            int carry = 0;
-            size_t max_len = std::max(a.digits.size(), b.digits.size());
-            result.digits.reserve(max_len + 1);
-            
-            for (size_t i = 0; i < max_len || carry; ++ i)
+            const __m256i base = _mm256_set1_epi32(BASE);
+            const __m256i top = _mm256_set1_epi32(BASE - 1);
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
             {
-                int sum = carry;
-                if (i < a.digits.size()) sum += a.digits[i];
-                if (i < b.digits.size()) sum += b.digits[i];
+                __m256i sum = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+                unsigned g = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(sum, top))));
+                unsigned p = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(sum, top))));
+                unsigned t = ((g << 1) | static_cast<unsigned>(carry)) + p;
+                unsigned c = (t ^ p) & 0xFF;
+                carry = static_cast<int>(t >> 8);
                 
-                if (sum >= BASE)
-                {
-                    result.digits.push_back(sum - BASE);
-                    carry = 1;
-                }
-                else
-                {
-                    result.digits.push_back(sum);
-                    carry = 0;
-                }
+                sum = _mm256_add_epi32(sum, _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(c)), lanes), one));
+                sum = _mm256_sub_epi32(sum, _mm256_and_si256(_mm256_cmpgt_epi32(sum, top), base));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), sum);
             }
-            result.is_negative = false;
+            return add_n_scalar(a + i, b + i, out + i, n - i, carry);
         }
-        
-        static void sub_abs(const bigint& a, const bigint& b, bigint& result) noexcept
+
+        IKUN_HPD_TARGET("avx2")
+        static int sub_n_avx2(const int* a, const int* b, int* out, size_t n, int borrow) noexcept
         {
-            result.digits.clear();
-            result.digits.reserve(a.digits.size());
-            int borrow = 0;
-            
-            for (size_t i = 0; i < a.digits.size(); ++ i)
+            const __m256i base = _mm256_set1_epi32(BASE);
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            size_t i = 0;
+            for (; i + 8 <= n; i += 8)
             {
-                int diff = a.digits[i] - borrow;
-                if (i < b.digits.size()) diff -= b.digits[i];
+                __m256i diff = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+                unsigned g = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(zero, diff))));
+                unsigned p = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(diff, zero))));
+                unsigned t = ((g << 1) | static_cast<unsigned>(borrow)) + p;
+                unsigned c = (t ^ p) & 0xFF;
+                borrow = static_cast<int>(t >> 8);
                 
-                if (diff < 0)
-                {
-                    diff += BASE;
-                    borrow = 1;
-                }
-                else
+                diff = _mm256_sub_epi32(diff, _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(c)), lanes), one));
+                diff = _mm256_add_epi32(diff, _mm256_and_si256(_mm256_cmpgt_epi32(zero, diff), base));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), diff);
+            }
+            return sub_n_scalar(a + i, b + i, out + i, n - i, borrow);
+        }
+
+        IKUN_HPD_TARGET("avx2")
+        static int compare_n_avx2(const int* a, const int* b, size_t n) noexcept
+        {
+            size_t i = n;
+            for (; i >= 8; i -= 8)
+            {
+                __m256i eq = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i - 8)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i - 8)));
+                unsigned diff = ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq))) & 0xFF;
+                if (diff)
                 {
-                    borrow = 0;
+                    size_t k = i - 8 + static_cast<size_t>(31 - std::countl_zero(diff));
+                    return a[k] > b[k] ? 1 : -1;
                 }
-                result.digits.push_back(diff);
             }
-            
-            result.trim();
-            result.is_negative = false;
+            return compare_n_scalar(a, b, i);
         }
-        
-        // 试商函数
-        static int eqd(const bigint& a, const bigint& b)
+
+        IKUN_HPD_TARGET("avx512f")
+        static int add_n_avx512(const int* a, const int* b, int* out, size_t n, int carry) noexcept
         {
-            if (a.digits.size() < b.digits.size()) return 0;
-            
-            // 取被除数和除数的最高两位进行估算
-            long long a_high = a.digits.back();
-            if (a.digits.size() > 1)
+            const __m512i base = _mm512_set1_epi32(BASE);
+            const __m512i top = _mm512_set1_epi32(BASE - 1);
+            const __m512i one = _mm512_set1_epi32(1);
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16)
             {
-                a_high = a_high * BASE + a.digits[a.digits.size() - 2];
+                __m512i sum = _mm512_add_epi32(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+                unsigned g = _mm512_cmpgt_epi32_mask(sum, top);
+                unsigned p = _mm512_cmpeq_epi32_mask(sum, top);
+                unsigned t = ((g << 1) | static_cast<unsigned>(carry)) + p;
+                __mmask16 c = static_cast<__mmask16>(t ^ p);
+                carry = static_cast<int>(t >> 16);
+                
+                sum = _mm512_mask_add_epi32(sum, c, sum, one);
+                sum = _mm512_mask_sub_epi32(sum, _mm512_cmpgt_epi32_mask(sum, top), sum, base);
+                _mm512_storeu_si512(out + i, sum);
             }
-            
-            long long b_high = b.digits.back();
-            if (b.digits.size() > 1)
+            return add_n_avx2(a + i, b + i, out + i, n - i, carry);
+        }
+
+        IKUN_HPD_TARGET("avx512f")
+        static int sub_n_avx512(const int* a, const int* b, int* out, size_t n, int borrow) noexcept
+        {
+            const __m512i base = _mm512_set1_epi32(BASE);
+            const __m512i zero = _mm512_setzero_si512();
+            const __m512i one = _mm512_set1_epi32(1);
+            size_t i = 0;
+            for (; i + 16 <= n; i += 16)
             {
-                b_high = b_high * BASE + b.digits[b.digits.size() - 2];
+                __m512i diff = _mm512_sub_epi32(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+                unsigned g = _mm512_cmplt_epi32_mask(diff, zero);
+                unsigned p = _mm512_cmpeq_epi32_mask(diff, zero);
+                unsigned t = ((g << 1) | static_cast<unsigned>(borrow)) + p;
+                __mmask16 c = static_cast<__mmask16>(t ^ p);
+                borrow = static_cast<int>(t >> 16);
+                
+                diff = _mm512_mask_sub_epi32(diff, c, diff, one);
+                diff = _mm512_mask_add_epi32(diff, _mm512_cmplt_epi32_mask(diff, zero), diff, base);
+                _mm512_storeu_si512(out + i, diff);
             }
-            
-            // 估算商位
-            long long q = a_high / (b_high + 1);  // 保守估计
-            return static_cast<int>(std::min(q, static_cast<long long>(BASE - 1)));
+            return sub_n_avx2(a + i, b + i, out + i, n - i, borrow);
         }
-        
-        // 朴素乘法(用于小规模乘法)
-        static void naive_multiply(const std::vector<int>& a, const std::vector<int>& b, std::vector<int>& result)
+
+        IKUN_HPD_TARGET("avx512f")
+        static int compare_n_avx512(const int* a, const int* b, size_t n) noexcept
         {
-            size_t a_size = a.size();
-            size_t b_size = b.size();
-            result.assign(a_size + b_size, 0);
-            
-            for (size_t i = 0; i < a_size; ++ i)
+            size_t i = n;
+            for (; i >= 16; i -= 16)
             {
-                long long carry = 0;
-                for (size_t j = 0; j < b_size || carry; ++ j)
+                unsigned diff = _mm512_cmpneq_epi32_mask(_mm512_loadu_si512(a + i - 16), _mm512_loadu_si512(b + i - 16));
+                if (diff)
                 {
-                    long long cur = result[i + j] + carry;
-                    if (j < b_size) cur += static_cast<long long>(a[i]) * b[j];
-                    result[i + j] = static_cast<int>(cur % BASE);
-                    carry = cur / BASE;
+                    size_t k = i - 16 + static_cast<size_t>(31 - std::countl_zero(diff));
+                    return a[k] > b[k] ? 1 : -1;
                 }
             }
-            
-            while (result.size() > 1 && result.back() == 0)
-            {
-                result.pop_back();
-            }
+            return compare_n_avx2(a, b, i);
         }
-        
-        // Karatsuba乘法算法
-        static void karatsuba_multiply(const std::vector<int>& a, const std::vector<int>& b, std::vector<int>& result)
+
+        // 检测CPU(及操作系统)支持的最高指令集
+        static simd_level detect_simd() noexcept
         {
-            size_t n = std::max(a.size(), b.size());
-            
-            // 如果规模较小，使用朴素乘法
-            if (n <= 32)
-            {
-                naive_multiply(a, b, result);
-                return;
-            }
-            
-            // 确保n是偶数
-            if (n % 2 == 1) ++n;
-            
-            size_t m = n / 2;
-            
-            // 分割a和b为高低两部分
-            std::vector<int> a_low(a.begin(), a.begin() + std::min(m, a.size()));
-            std::vector<int> a_high;
-            if (a.size() > m)
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return simd_level::avx512;
+            if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+#elif defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return simd_level::scalar;
+            __cpuid(info, 1);
+            bool osxsave = (info[2] >> 27) & 1;
+            if (!osxsave) return simd_level::scalar;
+            unsigned long long xcr0 = _xgetbv(0);
+            __cpuidex(info, 7, 0);
+            if ((info[1] >> 16 & 1) && (xcr0 & 0xE6) == 0xE6) return simd_level::avx512;
+            if ((info[1] >> 5 & 1) && (xcr0 & 0x6) == 0x6) return simd_level::avx2;
+#endif
+            return simd_level::scalar;
+        }
+#else
+        static simd_level detect_simd() noexcept
+        {
+            return simd_level::scalar;
+        }
+#endif
+
+        // 当前使用的指令集级别, 首次使用时检测
+        static std::atomic<simd_level>& simd_state() noexcept
+        {
+            static std::atomic<simd_level> level(detect_simd());
+            return level;
+        }
+
+        // 不足一个向量宽度时直接走标量循环, 不做分派
+        static int add_n(const int* a, const int* b, int* out, size_t n, int carry) noexcept
+        {
+#ifdef IKUN_HPD_X86_SIMD
+            if (n >= 8)
             {
-                a_high.assign(a.begin() + m, a.end());
+                switch (simd_state().load(std::memory_order_relaxed))
+                {
+                    case simd_level::avx512: return add_n_avx512(a, b, out, n, carry);
+                    case simd_level::avx2: return add_n_avx2(a, b, out, n, carry);
+                    default: break;
+                }
             }
-            else
+#endif
+            return add_n_scalar(a, b, out, n, carry);
+        }
+
+        static int sub_n(const int* a, const int* b, int* out, size_t n, int borrow) noexcept
+        {
+#ifdef IKUN_HPD_X86_SIMD
+            if (n >= 8)
             {
-                a_high.push_back(0);
+                switch (simd_state().load(std::memory_order_relaxed))
+                {
+                    case simd_level::avx512: return sub_n_avx512(a, b, out, n, borrow);
+                    case simd_level::avx2: return sub_n_avx2(a, b, out, n, borrow);
+                    default: break;
+                }
             }
-            
-            std::vector<int> b_low(b.begin(), b.begin() + std::min(m, b.size()));
-            std::vector<int> b_high;
-            if (b.size() > m)
+#endif
+            return sub_n_scalar(a, b, out, n, borrow);
+        }
+
+        static int compare_n(const int* a, const int* b, size_t n) noexcept
+        {
+#ifdef IKUN_HPD_X86_SIMD
+            if (n >= 8)
             {
-                b_high.assign(b.begin() + m, b.end());
+                switch (simd_state().load(std::memory_order_relaxed))
+                {
+                    case simd_level::avx512: return compare_n_avx512(a, b, n);
+                    case simd_level::avx2: return compare_n_avx2(a, b, n);
+                    default: break;
+                }
             }
-            else
+#endif
+            return compare_n_scalar(a, b, n);
+        }
+
+        // 比较两个单元数组表示的绝对值大小
+        static int compare_digits(const limb_vector& a, const limb_vector& b) noexcept
+        {
+            if (a.size() != b.size())
             {
-                b_high.push_back(0);
+                return a.size() > b.size() ? 1 : -1;
             }
+            return compare_n(a.data(), b.data(), a.size());
+        }
+        
+        // 比较绝对值大小
+        int compare_abs(const bigint& other) const noexcept
+        {
+            return compare_digits(digits, other.digits);
+        }
+        
+        // 加法辅助函数
+        static void add_abs(const bigint& a, const bigint& b, bigint& result) noexcept
+        {
+            const limb_vector& longer = a.digits.size() >= b.digits.size() ? a.digits : b.digits;
+            const limb_vector& shorter = a.digits.size() >= b.digits.size() ? b.digits : a.digits;
+            size_t n = shorter.size();
             
-            // 递归计算三个乘积
-            std::vector<int> z0, z1, z2;
-            
-            // z0 = a_low * b_low
-            karatsuba_multiply(a_low, b_low, z0);
-            
-            // z2 = a_high * b_high
-            karatsuba_multiply(a_high, b_high, z2);
-            
-            // 计算a_low + a_high 和 b_low + b_high
-            std::vector<int> a_sum(m + 1, 0);
-            std::vector<int> b_sum(m + 1, 0);
-            
-            for (size_t i = 0; i < m; ++ i)
+            // 公共部分用向量内核相加, 较长一方多出的部分只需传递进位
+            result.digits.resize(longer.size());
+            int carry = add_n(longer.data(), shorter.data(), result.digits.data(), n, 0);
+            for (size_t i = n; i < longer.size(); ++ i)
             {
-                int av = (i < a_low.size()) ? a_low[i] : 0;
-                int bv = (i < a_high.size()) ? a_high[i] : 0;
-                a_sum[i] = av + bv;
+                int sum = longer[i] + carry;
+                carry = sum == BASE;
+                result.digits[i] = carry ? 0 : sum;
             }
-            
-            for (size_t i = 0; i < m; ++ i)
+            if (carry) result.digits.push_back(1);
+            result.is_negative = false;
+        }
+        
+        // 减法辅助函数, 要求|a| >= |b|
+        static void sub_abs(const bigint& a, const bigint& b, bigint& result) noexcept
+        {
+            size_t n = b.digits.size();
+            result.digits.resize(a.digits.size());
+            int borrow = sub_n(a.digits.data(), b.digits.data(), result.digits.data(), n, 0);
+            for (size_t i = n; i < a.digits.size(); ++ i)
             {
-                int av = (i < b_low.size()) ? b_low[i] : 0;
-                int bv = (i < b_high.size()) ? b_high[i] : 0;
-                b_sum[i] = av + bv;
+                int diff = a.digits[i] - borrow;
+                borrow = diff < 0;
+                result.digits[i] = borrow ? BASE - 1 : diff;
             }
             
-            // 处理进位
-            for (size_t i = 0; i < m; ++ i)
+            result.trim();
+            result.is_negative = false;
+        }
+        
+        // 朴素乘法内核: out[0, na + nb) = a * b, out不能与a, b重叠
+        static void naive_multiply(const int* a, size_t na, const int* b, size_t nb, int* out) noexcept
+        {
+            std::fill(out, out + na + nb, 0);
+            for (size_t i = 0; i < na; ++ i)
             {
-                if (a_sum[i] >= BASE)
-                {
-                    a_sum[i] -= BASE;
-                    if (i + 1 < a_sum.size()) a_sum[i + 1]++;
-                }
-                if (b_sum[i] >= BASE)
+                long long carry = 0;
+                long long ai = a[i];
+                for (size_t j = 0; j < nb; ++ j)
                 {
-                    b_sum[i] -= BASE;
-                    if (i + 1 < b_sum.size()) b_sum[i + 1]++;
+                    long long cur = out[i + j] + ai * b[j] + carry;
+                    out[i + j] = static_cast<int>(cur % BASE);
+                    carry = cur / BASE;
                 }
+                out[i + nb] = static_cast<int>(carry);
             }
-            
-            // z1 = (a_low + a_high) * (b_low + b_high) - z0 - z2
-            std::vector<int> z1_temp;
-            karatsuba_multiply(a_sum, b_sum, z1_temp);
-            
-            // 从z1_temp中减去z0和z2
-            int borrow = 0;
-            size_t max_len = std::max(z1_temp.size(), std::max(z0.size(), z2.size()));
-            z1.assign(max_len, 0);
-            
-            for (size_t i = 0; i < max_len; ++i)
+        }
+        
+        // 乘加/乘减内核: out[0, na + nb) += a * b(subtract为true时为-=), 返回越过最高位的进位/借位
+        // 按列计算乘积的各个单元, 每列累加16项才归约一次, 算出一个单元就立即与out合并, 不需要存放乘积
+        // out不能与a, b重叠
+        static int addmul_n(int* out, const int* a, size_t na, const int* b, size_t nb, bool subtract) noexcept
+        {
+            const unsigned long long base = BASE;
+            unsigned long long carry = 0; // 乘积的列进位
+            int flow = 0;                 // 与out合并时的进位或借位
+            for (size_t t = 0; t < na + nb; ++ t)
             {
-                int val = borrow;
-                if (i < z1_temp.size()) val += z1_temp[i];
-                if (i < z0.size()) val -= z0[i];
-                if (i < z2.size()) val -= z2[i];
+                unsigned long long acc = carry % base;
+                carry /= base;
+                size_t i = t >= nb ? t - nb + 1 : 0;
+                size_t last = std::min(t, na - 1);
+                for (int count = 0; i <= last; ++ i)
+                {
+                    acc += static_cast<unsigned long long>(a[i]) * static_cast<unsigned long long>(b[t - i]);
+                    if (++ count == 16)
+                    {
+                        carry += acc / base;
+                        acc %= base;
+                        count = 0;
+                    }
+                }
+                carry += acc / base;
+                int limb = static_cast<int>(acc % base);
                 
-                if (val < 0)
+                if (subtract)
                 {
-                    val += BASE;
-                    borrow = -1;
+                    int diff = out[t] - limb - flow;
+                    flow = diff < 0;
+                    out[t] = flow ? diff + BASE : diff;
                 }
                 else
                 {
-                    borrow = 0;
+                    int sum = out[t] + limb + flow;
+                    flow = sum >= BASE;
+                    out[t] = flow ? sum - BASE : sum;
                 }
-                z1[i] = val;
-            }
-            
-            // 合并结果：result = z0 + z1 * BASE^m + z2 * BASE^(2m)
-            size_t result_size = z0.size() + 2 * m;
-            result.assign(result_size, 0);
-            
-            // 添加z0
-            for (size_t i = 0; i < z0.size(); ++ i)
-            {
-                result[i] = z0[i];
             }
-            
-            // 添加z1 * BASE^m
-            for (size_t i = 0; i < z1.size(); ++ i)
+            return flow;
+        }
+        
+        // 朴素平方内核: out[0, 2n) = a * a, 交叉项a[i] * a[j] (i < j)只计算一次后翻倍
+        static void naive_square(const int* a, size_t n, int* out) noexcept
+        {
+            std::fill(out, out + 2 * n, 0);
+            for (size_t i = 0; i + 1 < n; ++ i)
             {
-                result[i + m] += z1[i];
-                if (result[i + m] >= BASE)
+                long long carry = 0;
+                long long ai = a[i];
+                for (size_t j = i + 1; j < n; ++ j)
                 {
-                    result[i + m] -= BASE;
-                    if (i + m + 1 < result.size()) result[i + m + 1]++;
+                    long long cur = out[i + j] + ai * a[j] + carry;
+                    out[i + j] = static_cast<int>(cur % BASE);
+                    carry = cur / BASE;
                 }
+                out[i + n] = static_cast<int>(carry);
             }
             
-            // 添加z2 * BASE^(2m)
-            for (size_t i = 0; i < z2.size(); ++i)
+            // 交叉项翻倍后加上对角项a[i]^2
+            long long carry = 0;
+            for (size_t i = 0; i < n; ++ i)
             {
-                result[i + 2 * m] += z2[i];
-                if (result[i + 2 * m] >= BASE)
-                {
-                    result[i + 2 * m] -= BASE;
-                    if (i + 2 * m + 1 < result.size()) result[i + 2 * m + 1]++;
-                }
+                long long sq = static_cast<long long>(a[i]) * a[i];
+                long long low = 2LL * out[2 * i] + sq % BASE + carry;
+                out[2 * i] = static_cast<int>(low % BASE);
+                long long high = 2LL * out[2 * i + 1] + sq / BASE + low / BASE;
+                out[2 * i + 1] = static_cast<int>(high % BASE);
+                carry = high / BASE;
             }
+        }
+        
+        // 朴素乘法(用于小规模乘法)
+        static void naive_multiply(const limb_vector& a, const limb_vector& b, limb_vector& result)
+        {
+            result.resize(a.size() + b.size());
+            naive_multiply(a.data(), a.size(), b.data(), b.size(), result.data());
             
-            // 移除前导零
-            while (result.size() > 1 && result.back() == 0)
+            while (!result.empty() && result.back() == 0)
             {
                 result.pop_back();
             }
         }
-
-    public:
-        // 构造函数
-        bigint() : is_negative(false)
-        {
-            digits.push_back(0);
-        }
         
-        // 从字符串构造
-        bigint(const std::string& s)
+        // 将b * BASE^shift累加到a上(a需预留足够空间)
+        static void add_shifted(limb_vector& a, const limb_vector& b, size_t shift) noexcept
         {
-            if (s.empty())
+            int carry = 0;
+            size_t i = 0;
+            for (; i < b.size() || carry; ++ i)
             {
-                digits.push_back(0);
-                is_negative = false;
-                return;
+                int sum = a[i + shift] + carry;
+                if (i < b.size()) sum += b[i];
+                if (sum >= BASE)
+                {
+                    a[i + shift] = sum - BASE;
+                    carry = 1;
+                }
+                else
+                {
+                    a[i + shift] = sum;
+                    carry = 0;
+                }
             }
-            
-            size_t start = 0;
-            is_negative = false;
-            
-            // 处理符号
-            if (s[0] == '-')
+        }
+
+        // a[0, na) += b[0, nb), 要求na >= nb, 返回最高位的进位
+        static int add_in_place(int* a, size_t na, const int* b, size_t nb) noexcept
+        {
+            int carry = add_n(a, b, a, nb, 0);
+            for (size_t i = nb; carry && i < na; ++ i)
             {
-                is_negative = true;
-                start = 1;
+                carry = a[i] == BASE - 1;
+                a[i] = carry ? 0 : a[i] + 1;
             }
-            else if (s[0] == '+')
+            return carry;
+        }
+
+        // a[0, na) -= b[0, nb), 要求na >= nb, 返回最高位的借位
+        static int sub_in_place(int* a, size_t na, const int* b, size_t nb) noexcept
+        {
+            int borrow = sub_n(a, b, a, nb, 0);
+            for (size_t i = nb; borrow && i < na; ++ i)
             {
-                start = 1;
+                borrow = a[i] == 0;
+                a[i] = borrow ? BASE - 1 : a[i] - 1;
             }
-            
-            // 跳过前导零
-            while (start < s.size() && s[start] == '0')
+            return borrow;
+        }
+
+        // Karatsuba递归所需的临时空间(单元数)
+        static size_t karatsuba_scratch_size(size_t n) noexcept
+        {
+            size_t total = 0;
+            while (n > 32)
             {
-                start ++;
+                size_t h = n - n / 2;
+                total += 4 * (h + 1);
+                n = h + 1;
             }
-            
-            if (start == s.size())
+            return total;
+        }
+
+        // Karatsuba乘法内核: out[0, 2n) = a[0, n) * b[0, n)
+        // 所有中间结果都放在预先分配好的临时空间ws中, 递归过程不再申请内存
+        static void karatsuba_multiply(const int* a, const int* b, size_t n, int* out, int* ws) noexcept
+        {
+            // 如果规模较小，使用朴素乘法
+            if (n <= 32)
             {
-                digits.push_back(0);
-                is_negative = false;
+                naive_multiply(a, n, b, n, out);
                 return;
             }
             
-            // 计算需要的digits数量
-            size_t num_digits = (s.size() - start + BASE_DIGITS - 1) / BASE_DIGITS;
-            digits.resize(num_digits, 0);
+            // 低半部分m个单元, 高半部分h个单元
+            size_t m = n / 2;
+            size_t h = n - m;
             
-            // 从低位开始解析
-            int digit_index = 0;
-            long long current_value = 0;
-            int current_power = 1;
+            // z0 = a_low * b_low 放在out[0, 2m), z2 = a_high * b_high 放在out[2m, 2n)
+            karatsuba_multiply(a, b, m, out, ws);
+            karatsuba_multiply(a + m, b + m, h, out + 2 * m, ws);
             
-            for (int i = static_cast<int>(s.size()) - 1; i >= static_cast<int>(start); --i)
-            {
-                if (!isdigit(s[i]))
-                {
-                    throw_inv_arg("Invalid character in argument of bigint constructor",
-                        "high_precision_digit.hpp", "class bigint(in constructor)", "ikun_bigint 001"
-                    );
-                }
-                
-                current_value += (s[i] - '0') * current_power;
-                current_power *= 10;
-                
-                if (current_power == BASE)
-                {
-                    digits[digit_index++] = static_cast<int>(current_value);
-                    current_value = 0;
-                    current_power = 1;
-                }
-            }
+            // 计算a_low + a_high 和 b_low + b_high (各h + 1个单元)
+            int* a_sum = ws;
+            int* b_sum = ws + (h + 1);
+            int* z1 = ws + 2 * (h + 1);
+            std::copy(a + m, a + n, a_sum);
+            std::copy(b + m, b + n, b_sum);
+            a_sum[h] = add_in_place(a_sum, h, a, m);
+            b_sum[h] = add_in_place(b_sum, h, b, m);
+            
+            // z1 = (a_low + a_high) * (b_low + b_high) - z0 - z2
+            karatsuba_multiply(a_sum, b_sum, h + 1, z1, ws + 4 * (h + 1));
+            sub_in_place(z1, 2 * (h + 1), out, 2 * m);
+            sub_in_place(z1, 2 * (h + 1), out + 2 * m, 2 * h);
+            
+            // 合并结果: out += z1 * BASE^m (z1不超过n + 1个单元)
+            add_in_place(out + m, n + h, z1, n + 1);
+        }
+
+        // Karatsuba乘法: 整个乘法只申请结果和一块临时空间两次内存
+        static void karatsuba_multiply(const limb_vector& a, const limb_vector& b, limb_vector& result)
+        {
+            size_t n = std::max(a.size(), b.size());
+            
+            // 较短的一方补零到n个单元, 与递归临时空间放在同一块内存中
+            std::vector<int> buffer(2 * n + karatsuba_scratch_size(n), 0);
+            int* pa = buffer.data();
+            int* pb = buffer.data() + n;
+            std::copy(a.begin(), a.end(), pa);
+            std::copy(b.begin(), b.end(), pb);
             
-            if (current_value > 0)
+            result.resize(2 * n);
+            karatsuba_multiply(pa, pb, n, result.data(), buffer.data() + 2 * n);
+            
+            // 移除前导零
+            while (!result.empty() && result.back() == 0)
             {
-                digits[digit_index] = static_cast<int>(current_value);
+                result.pop_back();
             }
-            
-            trim();
         }
-        
-        // 从64位整数构造
-        bigint(long long n)
+
+        // Karatsuba平方内核: out[0, 2n) = a[0, n)^2, 三个子问题都是平方
+        static void karatsuba_square(const int* a, size_t n, int* out, int* ws) noexcept
         {
-            if (n == 0)
+            if (n <= 32)
             {
-                digits.push_back(0);
-                is_negative = false;
+                naive_square(a, n, out);
                 return;
             }
             
-            is_negative = n < 0;
-            unsigned long long un = static_cast<unsigned long long>(std::abs(n));
+            size_t m = n / 2;
+            size_t h = n - m;
             
-            while (un > 0)
+            karatsuba_square(a, m, out, ws);
+            karatsuba_square(a + m, h, out + 2 * m, ws);
+            
+            // z1 = (a_low + a_high)^2 - z0 - z2
+            int* a_sum = ws;
+            int* z1 = ws + (h + 1);
+            std::copy(a + m, a + n, a_sum);
+            a_sum[h] = add_in_place(a_sum, h, a, m);
+            
+            karatsuba_square(a_sum, h + 1, z1, ws + 3 * (h + 1));
+            sub_in_place(z1, 2 * (h + 1), out, 2 * m);
+            sub_in_place(z1, 2 * (h + 1), out + 2 * m, 2 * h);
+            
+            add_in_place(out + m, n + h, z1, n + 1);
+        }
+
+        // Karatsuba平方(临时空间与乘法共用同一估计, 平方实际用量更少)
+        static void karatsuba_square(const limb_vector& a, limb_vector& result)
+        {
+            size_t n = a.size();
+            std::vector<int> buffer(karatsuba_scratch_size(n));
+            result.resize(2 * n);
+            karatsuba_square(a.data(), n, result.data(), buffer.data());
+            
+            while (!result.empty() && result.back() == 0)
             {
-                digits.push_back(static_cast<int>(un % BASE));
-                un /= BASE;
+                result.pop_back();
             }
         }
-        
-        // 从vector构造
-        bigint(std::vector<int>&& d, bool neg = false) noexcept
-            : digits(std::move(d)), is_negative(neg)
+
+        // 快速幂取模(NTT辅助函数)
+        static unsigned pow_mod(unsigned long long b, unsigned long long e, unsigned mod) noexcept
         {
-            trim();
+            unsigned long long result = 1;
+            b %= mod;
+            while (e > 0)
+            {
+                if (e & 1) result = result * b % mod;
+                b = b * b % mod;
+                e >>= 1;
+            }
+            return static_cast<unsigned>(result);
         }
-        
-        // 移动构造函数
-        bigint(bigint&& other) noexcept
-            : digits(std::move(other.digits)), is_negative(other.is_negative)
+
+        // 多线程乘法的线程数上限(包括调用线程), 默认为1, 即不启动任何线程, 见set_thread_count()
+        static std::atomic<unsigned>& thread_limit() noexcept
         {
-            other.digits = {0};
-            other.is_negative = false;
+            static std::atomic<unsigned> limit(1);
+            return limit;
         }
         
-        // 复制构造函数
-        bigint(const bigint& other) = default;
-
-        // 便捷构造函数
-        bigint(int n) : bigint(static_cast<long long>(n)) {}
-        bigint(unsigned int n) : bigint(static_cast<long long>(n)) {}
-        bigint(unsigned long long n) : bigint(static_cast<long long>(n)) {}
-
-        // 从字符指针构造
-        bigint(const char* s) : bigint(std::string(s)) {}
-        
-        // 移动赋值运算符
-        bigint& operator=(bigint&& other) noexcept
+        // 常驻的辅助线程池, 第一次需要并行时才启动thread_limit() - 1个线程, 修改线程数时停止, 下次使用时按新的数量重新启动
+        // 队列中的任务只是帮忙的请求: 发起并行的线程自己也领取任务, 不会等待还没开始的请求, 所以池中线程都在忙时也不会死锁
+        class worker_pool
         {
-            if (this != &other)
+        public:
+            ~worker_pool()
             {
-                digits = std::move(other.digits);
-                is_negative = other.is_negative;
-                other.digits = {0};
-                other.is_negative = false;
+                stop();
             }
-            return *this;
-        }
-        
-        // 复制赋值运算符
-        bigint& operator=(const bigint& other) = default;
-        
-        // 转换为字符串
-        std::string to_string() const
-        {
-            if (digits.empty()) return "0";
-            
-            std::string result;
-            if (is_negative) result += '-';
             
-            // 最高位不需要前导零
-            result += std::to_string(digits.back());
-            
-            // 其余位需要补足9位
-            for (int i = static_cast<int>(digits.size()) - 2; i >= 0; --i)
+            // 提交任务, 线程池没有可用线程时返回false
+            bool submit(std::function<void()> task)
             {
-                char buf[10];
-                snprintf(buf, sizeof(buf), "%09d", digits[i]);
-                result += buf;
+                std::lock_guard<std::mutex> guard(lock);
+                if (stopping) return false;
+                if (workers.empty()) start();
+                if (workers.empty()) return false;
+                tasks.push_back(std::move(task));
+                ready.notify_one();
+                return true;
             }
             
-            return result;
-        }
-        
-        // 算术运算符
-        bigint operator+(const bigint& other) const
-        {
-            // 同号相加
-            if (is_negative == other.is_negative)
+            // 等正在执行的任务结束后停止所有线程, 未开始的请求直接丢弃(发起方会自己完成)
+            void stop()
             {
-                bigint result;
-                add_abs(*this, other, result);
-                result.is_negative = is_negative;
-                return result;
+                std::vector<std::thread> old;
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (stopping) return;
+                    stopping = true;
+                    old.swap(workers);
+                }
+                ready.notify_all();
+                for (std::thread& t : old) t.join();
+                std::lock_guard<std::mutex> guard(lock);
+                tasks.clear();
+                stopping = false;
             }
             
-            // 异号相减
-            int cmp = compare_abs(other);
-            if (cmp == 0) return bigint(0);
+        private:
+            std::mutex lock;
+            std::condition_variable ready;
+            std::deque<std::function<void()>> tasks;
+            std::vector<std::thread> workers;
+            bool stopping = false;
             
-            bigint result;
-            if (cmp > 0)
+            void start()
             {
-                sub_abs(*this, other, result);
-                result.is_negative = is_negative;
+                unsigned count = thread_limit().load(std::memory_order_relaxed) - 1;
+                try
+                {
+                    workers.reserve(count);
+                    for (unsigned i = 0; i < count; ++ i) workers.emplace_back([this] { run(); });
+                }
+                catch (...)
+                {
+                    // 线程创建失败时使用已经启动的线程
+                }
             }
-            else
+            
+            void run()
             {
-                sub_abs(other, *this, result);
-                result.is_negative = other.is_negative;
+                std::unique_lock<std::mutex> guard(lock);
+                while (true)
+                {
+                    ready.wait(guard, [this] { return stopping || !tasks.empty(); });
+                    if (stopping) return;
+                    std::function<void()> task = std::move(tasks.front());
+                    tasks.pop_front();
+                    guard.unlock();
+                    task();
+                    guard.lock();
+                }
             }
-            
-            return result;
-        }
+        };
         
-        // 复合赋值运算符
-        bigint& operator+=(const bigint& other)
+        static worker_pool& pool()
         {
-            *this = *this + other;
-            return *this;
+            static worker_pool instance;
+            return instance;
         }
         
-        bigint operator-(const bigint& other) const
+        // 所有乘法共享的辅助线程配额, 嵌套的并行任务只能使用剩余配额, 同时提交的帮忙请求不会超过线程池的大小
+        static std::atomic<unsigned>& threads_in_use() noexcept
         {
-            // 改变符号后相加
-            bigint temp = other;
-            temp.is_negative = !temp.is_negative;
-            return *this + temp;
+            static std::atomic<unsigned> used(0);
+            return used;
         }
         
-        bigint& operator-=(const bigint& other)
+        static unsigned acquire_threads(size_t want) noexcept
         {
-            *this = *this - other;
-            return *this;
+            std::atomic<unsigned>& used = threads_in_use();
+            unsigned current = used.load(std::memory_order_relaxed);
+            while (true)
+            {
+                unsigned limit = thread_limit().load(std::memory_order_relaxed) - 1;
+                unsigned take = current < limit ? static_cast<unsigned>(std::min<size_t>(want, limit - current)) : 0;
+                if (take == 0 || used.compare_exchange_weak(current, current + take, std::memory_order_relaxed))
+                {
+                    return take;
+                }
+            }
         }
         
-        // 乘法(自动选择算法)
-        bigint operator*(const bigint& other) const
+        // 一次parallel_for的共享状态, 线程池中的请求开始执行前检查closed, 发起方关闭后只等待已经开始的请求
+        struct parallel_job
         {
-            bigint result;
-            result.is_negative = is_negative != other.is_negative;
+            std::function<void(size_t)> body;
+            size_t count = 0;
+            std::atomic<size_t> next{0};
+            std::mutex lock;
+            std::condition_variable finished;
+            unsigned running = 0;
+            bool closed = false;
+            std::exception_ptr error;
             
-            // 如果有一个是0, 直接返回0
-            if ((digits.size() == 1 && digits[0] == 0) || 
-                (other.digits.size() == 1 && other.digits[0] == 0))
+            void work()
+            {
+                try
+                {
+                    for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count; ) body(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (!error) error = std::current_exception();
+                    next.store(count, std::memory_order_relaxed);
+                }
+            }
+        };
+        
+        // 并行执行fn(0), fn(1), ..., fn(count - 1), 各任务只能写入互不重叠的数据, 因此结果与线程数无关
+        // work为本次计算的规模, 不超过PARALLEL_THRESHOLD时直接在当前线程依次执行
+        template <typename F>
+        static void parallel_for(size_t count, size_t work, F&& fn)
+        {
+            unsigned helpers = work > PARALLEL_THRESHOLD && count > 1 ? acquire_threads(count - 1) : 0;
+            if (helpers == 0)
             {
-                return bigint(0);
+                for (size_t i = 0; i < count; ++ i) fn(i);
+                return;
             }
             
-            // 根据规模选择乘法算法
-            if (digits.size() > 64 && other.digits.size() > 64)
+            auto job = std::make_shared<parallel_job>();
+            job->body = [&fn](size_t i) { fn(i); };
+            job->count = count;
+            try
             {
-                // 使用Karatsuba算法
-                karatsuba_multiply(digits, other.digits, result.digits);
+                for (unsigned i = 0; i < helpers; ++ i)
+                {
+                    bool queued = pool().submit([job]
+                    {
+                        {
+                            std::lock_guard<std::mutex> guard(job->lock);
+                            if (job->closed) return;
+                            ++ job->running;
+                        }
+                        job->work();
+                        {
+                            std::lock_guard<std::mutex> guard(job->lock);
+                            -- job->running;
+                        }
+                        job->finished.notify_all();
+                    });
+                    if (!queued) break;
+                }
             }
-            else
+            catch (...)
             {
-                // 使用朴素乘法
-                naive_multiply(digits, other.digits, result.digits);
+                // 提交失败时由当前线程完成剩余任务
             }
             
-            result.trim();
-            return result;
+            job->work();
+            {
+                std::unique_lock<std::mutex> guard(job->lock);
+                job->closed = true;
+                job->finished.wait(guard, [&] { return job->running == 0; });
+            }
+            threads_in_use().fetch_sub(helpers, std::memory_order_relaxed);
+            if (job->error) std::rethrow_exception(job->error);
         }
-        
-        bigint& operator*=(const bigint& other)
+
+        // 一层蝶形运算中的一段: lo[j], hi[j]与单位根w[j]做蝶形运算
+        template <unsigned MOD>
+        static void ntt_butterflies(unsigned* lo, unsigned* hi, const unsigned* w, size_t count) noexcept
         {
-            *this = *this * other;
-            return *this;
+            for (size_t j = 0; j < count; ++ j)
+            {
+                unsigned u = lo[j];
+                unsigned v = static_cast<unsigned>(static_cast<unsigned long long>(hi[j]) * w[j] % MOD);
+                lo[j] = u + v < MOD ? u + v : u + v - MOD;
+                hi[j] = u >= v ? u - v : u + MOD - v;
+            }
         }
         
-        // 优化除法
-        bigint operator/(const bigint& other) const
+        // 长度为len的一层的单位根w^from, w^(from + 1), ..., 共count个
+        template <unsigned MOD, unsigned G>
+        static void ntt_roots(unsigned* w, size_t len, bool invert, size_t from, size_t count) noexcept
         {
-            if (other == bigint(0))
+            unsigned long long wlen = pow_mod(G, (MOD - 1) / len, MOD);
+            if (invert) wlen = pow_mod(wlen, MOD - 2, MOD);
+            
+            w[0] = pow_mod(wlen, from, MOD);
+            for (size_t j = 1; j < count; ++ j)
             {
-                throw_re("Division by zero",
-                    "high_precision_digit.hpp", "class bigint in operator/", "ikun_bigint 002"
-                );
+                w[j] = static_cast<unsigned>(w[j - 1] * wlen % MOD);
             }
+        }
+
+        // 数论变换, MOD = c * 2^k + 1, G为MOD的原根
+        // 多线程时把数组分成parts段, 各段独立完成长度不超过n / parts的各层, 剩余各层再把每层的蝶形运算按下标分段并行
+        template <unsigned MOD, unsigned G>
+        static void ntt(std::vector<unsigned>& a, bool invert)
+        {
+            size_t n = a.size();
             
-            bigint a = *this;
-            bigint b = other;
-            a.is_negative = false;
-            b.is_negative = false;
+            // 位逆序置换
+            for (size_t i = 1, j = 0; i < n; ++ i)
+            {
+                size_t bit = n >> 1;
+                for (; j & bit; bit >>= 1) j ^= bit;
+                j ^= bit;
+                if (i < j) std::swap(a[i], a[j]);
+            }
             
-            if (a < b) return bigint(0);
+            size_t parts = 1;
+            if (n > PARALLEL_THRESHOLD)
+            {
+                parts = std::bit_floor(static_cast<size_t>(thread_limit().load(std::memory_order_relaxed)));
+                while (parts > 1 && n / parts < 4096) parts /= 2;
+            }
+            size_t span = n / parts;
             
-            bigint result;
-            bigint current;
-            result.is_negative = is_negative != other.is_negative;
+            parallel_for(parts, n, [&](size_t p)
+            {
+                std::vector<unsigned> w(span / 2);
+                unsigned* block = a.data() + p * span;
+                for (size_t len = 2; len <= span; len <<= 1)
+                {
+                    size_t half = len / 2;
+                    ntt_roots<MOD, G>(w.data(), len, invert, 0, half);
+                    for (size_t i = 0; i < span; i += len)
+                    {
+                        ntt_butterflies<MOD>(block + i, block + i + half, w.data(), half);
+                    }
+                }
+            });
             
-            // 结果的最大位数
-            result.digits.resize(a.digits.size() - b.digits.size() + 1, 0);
+            for (size_t len = span * 2; len <= n; len <<= 1)
+            {
+                size_t half = len / 2, step = half / parts;
+                parallel_for(parts, n, [&](size_t p)
+                {
+                    std::vector<unsigned> w(step);
+                    ntt_roots<MOD, G>(w.data(), len, invert, p * step, step);
+                    for (size_t i = 0; i < n; i += len)
+                    {
+                        ntt_butterflies<MOD>(a.data() + i + p * step, a.data() + i + half + p * step, w.data(), step);
+                    }
+                });
+            }
             
-            // 将除数左移, 使其与被除数最高位对齐
-            size_t shift = a.digits.size() - b.digits.size();
-            std::vector<int> b_shifted(b.digits);
-            b_shifted.insert(b_shifted.begin(), shift, 0);
+            if (invert)
+            {
+                unsigned long long n_inv = pow_mod(n, MOD - 2, MOD);
+                parallel_for(parts, n, [&](size_t p)
+                {
+                    for (size_t i = p * span; i < (p + 1) * span; ++ i)
+                    {
+                        a[i] = static_cast<unsigned>(a[i] * n_inv % MOD);
+                    }
+                });
+            }
+        }
+
+        // 在单个模数下计算卷积
+        template <unsigned MOD, unsigned G>
+        static std::vector<unsigned> ntt_convolution(const limb_vector& a, const limb_vector& b, size_t n)
+        {
+            // 平方时只需一次正变换
+            bool same = &a == &b;
+            std::vector<unsigned> fa(n, 0), fb(same ? 0 : n, 0);
+            parallel_for(same ? 1 : 2, n, [&](size_t i)
+            {
+                const limb_vector& src = i == 0 ? a : b;
+                std::vector<unsigned>& dst = i == 0 ? fa : fb;
+                for (size_t j = 0; j < src.size(); ++ j) dst[j] = static_cast<unsigned>(src[j]) % MOD;
+                ntt<MOD, G>(dst, false);
+            });
             
-            bigint divisor(std::move(b_shifted), false);
+            const std::vector<unsigned>& other = same ? fa : fb;
+            for (size_t i = 0; i < n; ++ i)
+            {
+                fa[i] = static_cast<unsigned>(static_cast<unsigned long long>(fa[i]) * other[i] % MOD);
+            }
+            ntt<MOD, G>(fa, true);
+            return fa;
+        }
+
+        // 三模数NTT乘法(用于超大规模乘法), 通过CRT合并三个模数下的卷积结果
+        static void ntt_multiply(const limb_vector& a, const limb_vector& b, limb_vector& result)
+        {
+            // 三个模数之积约为5.9e25, 每个卷积系数不超过min(a, b) * 10^18
+            // 变换长度受754974721 = 45 * 2^24 + 1限制, 最多2^24
+            const unsigned M1 = 167772161, M2 = 469762049, M3 = 754974721;
+            const size_t MAX_LEN = size_t(1) << 24;
             
-            for (int i = static_cast<int>(shift); i >= 0; --i)
+            // 超出变换长度时拆分较长的一方, 分别相乘后合并
+            if (a.size() + b.size() - 1 > MAX_LEN)
             {
-                // 估算商位
-                int q = eqd(a, divisor);
+                const limb_vector& longer = a.size() >= b.size() ? a : b;
+                const limb_vector& shorter = a.size() >= b.size() ? b : a;
+                size_t half = longer.size() / 2;
+                limb_vector low(longer.begin(), longer.begin() + half);
+                limb_vector high(longer.begin() + half, longer.end());
+                limb_vector high_product;
                 
-                // 调整商位
-                bigint product = divisor * bigint(q);
-                while (product > a)
+                parallel_for(2, MAX_LEN, [&](size_t i)
                 {
-                    -- q;
-                    product = divisor * bigint(q);
-                }
-                
-                result.digits[i] = q;
-                a = a - product;
+                    if (i == 0) ntt_multiply(low, shorter, result);
+                    else ntt_multiply(high, shorter, high_product);
+                });
+                result.resize(std::max(result.size(), high_product.size() + half) + 1, 0);
+                add_shifted(result, high_product, half);
                 
-                // 除数右移一位
-                if (i > 0)
+                while (!result.empty() && result.back() == 0)
                 {
-                    divisor.digits.erase(divisor.digits.begin());
+                    result.pop_back();
                 }
+                return;
             }
             
-            result.trim();
-            return result;
-        }
-        
-        bigint& operator/=(const bigint& other)
-        {
+            size_t conv_len = a.size() + b.size() - 1;
+            size_t n = 1;
+            while (n < conv_len) n <<= 1;
+            
+            // 三个模数下的卷积互不依赖, 可以并行计算
+            std::vector<unsigned> r1, r2, r3;
+            parallel_for(3, n, [&](size_t i)
+            {
+                if (i == 0) r1 = ntt_convolution<M1, 3>(a, b, n);
+                else if (i == 1) r2 = ntt_convolution<M2, 3>(a, b, n);
+                else r3 = ntt_convolution<M3, 11>(a, b, n);
+            });
+            
+            // Garner算法: x = x1 + M1 * v2 + M1 * M2 * v3
+            const unsigned long long m1_inv_m2 = pow_mod(M1, M2 - 2, M2);
+            const unsigned long long m12_mod_m3 = static_cast<unsigned long long>(M1) * M2 % M3;
+            const unsigned long long m12_inv_m3 = pow_mod(m12_mod_m3, M3 - 2, M3);
+            
+            // M1 * M2 = m12_high * BASE + m12_low
+            const unsigned long long m12 = static_cast<unsigned long long>(M1) * M2;
+            const unsigned long long m12_high = m12 / BASE, m12_low = m12 % BASE;
+            
+            result.assign(conv_len + 3, 0);
+            unsigned long long carry = 0;
+            for (size_t i = 0; i < conv_len; ++ i)
+            {
+                unsigned long long x1 = r1[i];
+                unsigned long long v2 = (r2[i] + M2 - x1 % M2) % M2 * m1_inv_m2 % M2;
+                unsigned long long t = x1 + M1 * v2; // t < M1 * M2
+                unsigned long long v3 = (r3[i] + M3 - t % M3) % M3 * m12_inv_m3 % M3;
+                
+                // 系数 = t + M1 * M2 * v3, 拆成BASE进制逐位累加, 全程不超过64位
+                unsigned long long low = carry + t + m12_low * v3;
+                result[i] = static_cast<int>(low % BASE);
+                carry = low / BASE + m12_high * v3;
+            }
+            for (size_t i = conv_len; carry > 0; ++ i)
+            {
+                result[i] = static_cast<int>(carry % BASE);
+                carry /= BASE;
+            }
+            
+            while (!result.empty() && result.back() == 0)
+            {
+                result.pop_back();
+            }
+        }
+
+        // 64位整数的绝对值(LLONG_MIN也能正确处理)
+        static unsigned long long abs_ll(long long n) noexcept
+        {
+            return n < 0 ? 0ULL - static_cast<unsigned long long>(n) : static_cast<unsigned long long>(n);
+        }
+
+        // 64位乘法的高64位
+        static unsigned long long mul_high(unsigned long long a, unsigned long long b) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            return static_cast<unsigned long long>((static_cast<unsigned __int128>(a) * b) >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            return __umulh(a, b);
+#else
+            unsigned long long a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+            unsigned long long b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+            unsigned long long lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi;
+            unsigned long long mid = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+            return a_hi * b_hi + (hi_lo >> 32) + (mid >> 32);
+#endif
+        }
+
+        // 预计算倒数的单字除数, 用一次乘法和最多两次修正代替硬件除法
+        struct word_divisor
+        {
+            unsigned long long d;
+            unsigned long long inv; // floor((2^64 - 1) / d)
+            
+            explicit word_divisor(unsigned long long divisor) noexcept
+                : d(divisor), inv(~0ULL / divisor) {}
+            
+            // 返回x / d, 余数写入rem
+            unsigned long long divide(unsigned long long x, unsigned long long& rem) const noexcept
+            {
+                unsigned long long q = mul_high(x, inv); // 不大于真实的商, 且最多小2
+                rem = x - q * d;
+                while (rem >= d)
+                {
+                    ++ q;
+                    rem -= d;
+                }
+                return q;
+            }
+        };
+
+        // 单元数组乘以小于BASE的非负整数(原地)
+        static void mul_small(limb_vector& v, int m)
+        {
+            long long carry = 0;
+            for (size_t i = 0; i < v.size(); ++ i)
+            {
+                long long cur = static_cast<long long>(v[i]) * m + carry;
+                v[i] = static_cast<int>(cur % BASE);
+                carry = cur / BASE;
+            }
+            if (carry > 0) v.push_back(static_cast<int>(carry));
+            while (!v.empty() && v.back() == 0)
+            {
+                v.pop_back();
+            }
+        }
+
+        // 单元数组除以小于BASE的正整数(原地), 返回余数
+        static int div_small(limb_vector& v, int d) noexcept
+        {
+            word_divisor divisor(static_cast<unsigned long long>(d));
+            unsigned long long rem = 0;
+            for (size_t i = v.size(); i -- > 0; )
+            {
+                v[i] = static_cast<int>(divisor.divide(rem * BASE + v[i], rem));
+            }
+            while (!v.empty() && v.back() == 0)
+            {
+                v.pop_back();
+            }
+            return static_cast<int>(rem);
+        }
+
+        // 单元数组对小于BASE的正整数取余(只求余数)
+        static int mod_small(const limb_vector& v, int d) noexcept
+        {
+            word_divisor divisor(static_cast<unsigned long long>(d));
+            unsigned long long rem = 0;
+            for (size_t i = v.size(); i -- > 0; )
+            {
+                divisor.divide(rem * BASE + v[i], rem);
+            }
+            return static_cast<int>(rem);
+        }
+
+        // 与64位整数比较, 返回-1, 0, 1
+        int compare_ll(long long n) const noexcept
+        {
+            bool n_negative = n < 0;
+            if (is_negative != n_negative)
+            {
+                return is_negative ? -1 : 1;
+            }
+            
+            // 同号时比较绝对值, 64位整数最多3个单元
+            int limbs[3];
+            size_t count = 0;
+            for (unsigned long long un = abs_ll(n); un > 0; un /= BASE)
+            {
+                limbs[count ++] = static_cast<int>(un % BASE);
+            }
+            
+            int cmp = 0;
+            if (digits.size() != count)
+            {
+                cmp = digits.size() > count ? 1 : -1;
+            }
+            else
+            {
+                for (size_t i = count; i -- > 0; )
+                {
+                    if (digits[i] != limbs[i])
+                    {
+                        cmp = digits[i] > limbs[i] ? 1 : -1;
+                        break;
+                    }
+                }
+            }
+            return is_negative ? -cmp : cmp;
+        }
+
+        // 取出单元数组中从from开始的len个单元, 构成非负大数
+        static bigint slice(const limb_vector& v, size_t from, size_t len)
+        {
+            if (from >= v.size()) return bigint(0);
+            size_t to = std::min(v.size(), from + len);
+            return bigint(limb_vector(v.begin() + from, v.begin() + to), false);
+        }
+
+        // 带符号的大数相乘(Toom-Cook求值点上的乘积可能为负)
+        static bigint signed_multiply(const bigint& a, const bigint& b)
+        {
+            bigint result;
+            multiply_digits(a.digits, b.digits, result.digits);
+            result.is_negative = a.is_negative != b.is_negative;
+            result.trim();
+            return result;
+        }
+
+        // 精确除以小整数(Toom-Cook插值用, 保证能整除)
+        static bigint div_exact(bigint a, int d)
+        {
+            div_small(a.digits, d);
+            a.trim();
+            return a;
+        }
+
+        // 将插值得到的系数按x = BASE^k合并到结果中(所有系数均非负)
+        static void toom_compose(const bigint* coeffs, size_t count, size_t k, size_t result_size, limb_vector& result)
+        {
+            result.assign(result_size + 1, 0);
+            for (size_t i = 0; i < count; ++ i)
+            {
+                add_shifted(result, coeffs[i].digits, i * k);
+            }
+            while (!result.empty() && result.back() == 0)
+            {
+                result.pop_back();
+            }
+        }
+
+        // Toom-3求值: 按k个单元分成三段, 依次求出0, 1, -1, -2, ∞处的值
+        static void toom3_evaluate(const limb_vector& a, size_t k, bigint* points)
+        {
+            bigint a0 = slice(a, 0, k), a1 = slice(a, k, k), a2 = slice(a, 2 * k, a.size());
+            bigint pa = a0 + a2;
+            points[1] = pa + a1;
+            points[2] = pa - a1;
+            points[3] = (points[2] + a2) * 2 - a0;
+            points[0] = std::move(a0);
+            points[4] = std::move(a2);
+        }
+
+        // 逐点相乘, 两个乘数相同时改为逐点平方
+        static void pointwise_multiply(const bigint* pa, const bigint* pb, size_t count, bigint* products)
+        {
+            for (size_t i = 0; i < count; ++ i)
+            {
+                products[i] = signed_multiply(pa[i], pa == pb ? pa[i] : pb[i]);
+            }
+        }
+
+        // Toom-3乘法, 求值点为0, 1, -1, -2, ∞, 插值采用Bodrato序列
+        static void toom3_multiply(const limb_vector& a, const limb_vector& b, limb_vector& result)
+        {
+            size_t k = (std::max(a.size(), b.size()) + 2) / 3;
+            
+            // 求值(平方时只需求一次)
+            bigint pa[5], pb[5], r[5];
+            toom3_evaluate(a, k, pa);
+            if (&a != &b) toom3_evaluate(b, k, pb);
+            pointwise_multiply(pa, &a == &b ? pa : pb, 5, r);
+            
+            bigint& r0 = r[0];
+            bigint& r1 = r[1];
+            bigint& rm1 = r[2];
+            bigint& rm2 = r[3];
+            bigint& rinf = r[4];
+            
+            // 插值
+            bigint r3 = div_exact(rm2 - r1, 3);
+            r1 = div_exact(r1 - rm1, 2);
+            bigint r2 = rm1 - r0;
+            r3 = div_exact(r2 - r3, 2) + rinf * 2;
+            r2 = r2 + r1 - rinf;
+            r1 = r1 - r3;
+            
+            const bigint coeffs[] = {r0, r1, r2, r3, rinf};
+            toom_compose(coeffs, 5, k, a.size() + b.size(), result);
+        }
+
+        // Toom-4求值: 按k个单元分成四段, 依次求出0, 1, -1, 2, -2, 1/2(乘以8), ∞处的值
+        static void toom4_evaluate(const limb_vector& a, size_t k, bigint* points)
+        {
+            bigint a0 = slice(a, 0, k), a1 = slice(a, k, k), a2 = slice(a, 2 * k, k), a3 = slice(a, 3 * k, a.size());
+            
+            // 按奇偶次项分开以复用中间结果
+            bigint ae = a0 + a2, ao = a1 + a3;
+            bigint ae2 = a0 + a2 * 4, ao2 = a1 * 2 + a3 * 8;
+            points[1] = ae + ao;
+            points[2] = ae - ao;
+            points[3] = ae2 + ao2;
+            points[4] = ae2 - ao2;
+            points[5] = a0 * 8 + a1 * 4 + a2 * 2 + a3;
+            points[0] = std::move(a0);
+            points[6] = std::move(a3);
+        }
+
+        // Toom-4乘法, 求值点为0, 1, -1, 2, -2, 1/2, ∞
+        static void toom4_multiply(const limb_vector& a, const limb_vector& b, limb_vector& result)
+        {
+            size_t k = (std::max(a.size(), b.size()) + 3) / 4;
+            
+            // 求值(平方时只需求一次)
+            bigint pa[7], pb[7], r[7];
+            toom4_evaluate(a, k, pa);
+            if (&a != &b) toom4_evaluate(b, k, pb);
+            pointwise_multiply(pa, &a == &b ? pa : pb, 7, r);
+            
+            bigint& r0 = r[0];
+            bigint& r1 = r[1];
+            bigint& rm1 = r[2];
+            bigint& r2 = r[3];
+            bigint& rm2 = r[4];
+            bigint& rh = r[5]; // 64 * c(1/2)
+            bigint& rinf = r[6];
+            
+            // 插值: 先由±1, ±2处的值分离出偶次项c2, c4
+            bigint e1 = div_exact(r1 + rm1, 2) - r0 - rinf;               // c2 + c4
+            bigint o1 = div_exact(r1 - rm1, 2);                           // c1 + c3 + c5
+            bigint e2 = div_exact(div_exact(r2 + rm2, 2) - r0 - rinf * 64, 4); // c2 + 4c4
+            bigint o2 = div_exact(r2 - rm2, 4);                           // c1 + 4c3 + 16c5
+            bigint c4 = div_exact(e2 - e1, 3);
+            bigint c2 = e1 - c4;
+            
+            // 再结合1/2处的值解出奇次项c1, c3, c5
+            bigint h = div_exact(rh - r0 * 64 - rinf - c2 * 16 - c4 * 4, 2); // 16c1 + 4c3 + c5
+            bigint t1 = div_exact(o2 - o1, 3);                            // c3 + 5c5
+            bigint t2 = div_exact(o1 * 16 - h, 3);                        // 4c3 + 5c5
+            bigint c3 = div_exact(t2 - t1, 3);
+            bigint c5 = div_exact(t1 - c3, 5);
+            bigint c1 = o1 - c3 - c5;
+            
+            const bigint coeffs[] = {r0, c1, c2, c3, c4, c5, rinf};
+            toom_compose(coeffs, 7, k, a.size() + b.size(), result);
+        }
+
+        // 根据规模选择乘法算法(只处理绝对值)
+        static void multiply_digits(const limb_vector& a, const limb_vector& b, limb_vector& result)
+        {
+            // 同一个对象相乘时走平方路径
+            if (&a == &b)
+            {
+                square_digits(a, result);
+                return;
+            }
+            
+            size_t n = std::min(a.size(), b.size());
+            size_t m = std::max(a.size(), b.size());
+            
+            // 两数规模相差悬殊时, 将较长的一方按较短一方的长度分块相乘, 使每块都能用上快速乘法
+            if (n > KARATSUBA_THRESHOLD && n <= NTT_THRESHOLD && m >= 2 * n)
+            {
+                const limb_vector& longer = a.size() >= b.size() ? a : b;
+                const limb_vector& shorter = a.size() >= b.size() ? b : a;
+                limb_vector chunk, part;
+                result.assign(m + n + 1, 0);
+                for (size_t from = 0; from < m; from += n)
+                {
+                    chunk.assign(longer.begin() + from, longer.begin() + std::min(m, from + n));
+                    while (!chunk.empty() && chunk.back() == 0) chunk.pop_back();
+                    multiply_digits(chunk, shorter, part);
+                    add_shifted(result, part, from);
+                }
+                while (!result.empty() && result.back() == 0)
+                {
+                    result.pop_back();
+                }
+                return;
+            }
+            
+            if (n > NTT_THRESHOLD)
+            {
+                ntt_multiply(a, b, result);
+            }
+            else if (n > TOOM4_THRESHOLD)
+            {
+                toom4_multiply(a, b, result);
+            }
+            else if (n > TOOM3_THRESHOLD)
+            {
+                toom3_multiply(a, b, result);
+            }
+            else if (n > KARATSUBA_THRESHOLD)
+            {
+                karatsuba_multiply(a, b, result);
+            }
+            else
+            {
+                naive_multiply(a, b, result);
+            }
+        }
+
+        // 根据规模选择平方算法(只处理绝对值), 阈值与乘法相同
+        // Toom和NTT直接复用乘法实现, 检测到两个乘数是同一对象时只求值/变换一次
+        static void square_digits(const limb_vector& a, limb_vector& result)
+        {
+            size_t n = a.size();
+            if (n > NTT_THRESHOLD)
+            {
+                ntt_multiply(a, a, result);
+            }
+            else if (n > TOOM4_THRESHOLD)
+            {
+                toom4_multiply(a, a, result);
+            }
+            else if (n > TOOM3_THRESHOLD)
+            {
+                toom3_multiply(a, a, result);
+            }
+            else if (n > KARATSUBA_THRESHOLD)
+            {
+                karatsuba_square(a, result);
+            }
+            else
+            {
+                result.resize(2 * n);
+                naive_square(a.data(), n, result.data());
+                while (!result.empty() && result.back() == 0)
+                {
+                    result.pop_back();
+                }
+            }
+        }
+
+        // 长除法(Knuth算法D): 计算|a| / |b|的商和余数, 要求b非零
+        // 先将除数规格化使最高单元不小于BASE / 2, 此时每个试商最多修正两次
+        static void divmod_digits(const limb_vector& a, const limb_vector& b,
+            limb_vector& quotient, limb_vector& remainder)
+        {
+            size_t n = b.size();
+            
+            // 被除数小于除数
+            if (compare_digits(a, b) < 0)
+            {
+                quotient.clear();
+                remainder = a;
+                return;
+            }
+            
+            // 除数只有一个单元, 直接逐位相除
+            if (n == 1)
+            {
+                quotient = a;
+                remainder.assign(1, div_small(quotient, b[0]));
+                return;
+            }
+            
+            // 除数和商都较长时使用递归除法, 代价与乘法相当
+            if (n > BZ_THRESHOLD && a.size() - n > BZ_THRESHOLD)
+            {
+                bz_divmod(a, b, quotient, remainder);
+                return;
+            }
+            
+            size_t m = a.size() - n;
+            int d = BASE / (b.back() + 1); // 规格化因子
+            
+            // u = a * d (多出一个单元), v = b * d
+            std::vector<int> u(a.size() + 1), v(n);
+            long long carry = 0;
+            for (size_t i = 0; i < a.size(); ++ i)
+            {
+                long long cur = static_cast<long long>(a[i]) * d + carry;
+                u[i] = static_cast<int>(cur % BASE);
+                carry = cur / BASE;
+            }
+            u[a.size()] = static_cast<int>(carry);
+            carry = 0;
+            for (size_t i = 0; i < n; ++ i)
+            {
+                long long cur = static_cast<long long>(b[i]) * d + carry;
+                v[i] = static_cast<int>(cur % BASE);
+                carry = cur / BASE;
+            }
+            
+            const long long v1 = v[n - 1], v2 = v[n - 2];
+            quotient.assign(m + 1, 0);
+            
+            for (size_t j = m + 1; j -- > 0; )
+            {
+                // 用被除数的最高两个单元估算商, 再用次高单元修正
+                long long num = static_cast<long long>(u[j + n]) * BASE + u[j + n - 1];
+                long long qhat = num / v1;
+                long long rhat = num % v1;
+                while (qhat >= BASE || qhat * v2 > rhat * BASE + u[j + n - 2])
+                {
+                    -- qhat;
+                    rhat += v1;
+                    if (rhat >= BASE) break;
+                }
+                
+                // u[j, j + n] -= qhat * v
+                long long mul_carry = 0, borrow = 0;
+                for (size_t i = 0; i < n; ++ i)
+                {
+                    long long p = qhat * v[i] + mul_carry;
+                    mul_carry = p / BASE;
+                    long long t = u[i + j] - p % BASE - borrow;
+                    borrow = t < 0;
+                    u[i + j] = static_cast<int>(borrow ? t + BASE : t);
+                }
+                long long top = u[j + n] - mul_carry - borrow;
+                
+                // 试商仍然偏大(概率约为2 / BASE), 加回一次除数
+                if (top < 0)
+                {
+                    -- qhat;
+                    int add_carry = add_in_place(&u[j], n, v.data(), n);
+                    top += add_carry;
+                }
+                u[j + n] = static_cast<int>(top);
+                quotient[j] = static_cast<int>(qhat);
+            }
+            
+            // 余数 = u[0, n) / d
+            remainder.assign(u.data(), u.data() + n);
+            div_small(remainder, d);
+            
+            while (!quotient.empty() && quotient.back() == 0)
+            {
+                quotient.pop_back();
+            }
+        }
+
+        // 乘以BASE^k (在低位补k个零单元)
+        static bigint shift_limbs(bigint a, size_t k)
+        {
+            if (!a.is_zero()) a.digits.insert(a.digits.begin(), k, 0);
+            return a;
+        }
+
+        // Burnikel-Ziegler: 计算2n个单元除以n个单元, 要求a < b * BASE^n且b已规格化
+        static void bz_divide_2n_1n(const bigint& a, const bigint& b, size_t n, bigint& q, bigint& r)
+        {
+            // n为奇数或规模较小时直接使用长除法
+            if (n % 2 == 1 || n <= BZ_THRESHOLD)
+            {
+                q = bigint();
+                r = bigint();
+                divmod_digits(a.digits, b.digits, q.digits, r.digits);
+                q.trim();
+                r.trim();
+                return;
+            }
+            
+            // a = [a1, a2, a3, a4], 每块n / 2个单元, 分两次做3n / 2n除法
+            size_t half = n / 2;
+            bigint q1, q2, r1;
+            bz_divide_3n_2n(slice(a.digits, half, a.digits.size()), b, half, q1, r1);
+            bz_divide_3n_2n(shift_limbs(r1, half) + slice(a.digits, 0, half), b, half, q2, r);
+            q = shift_limbs(q1, half) + q2;
+        }
+
+        // Burnikel-Ziegler: 计算3个半块除以2个半块(b为2 * half个单元)
+        static void bz_divide_3n_2n(const bigint& a, const bigint& b, size_t half, bigint& q, bigint& r)
+        {
+            bigint b1 = slice(b.digits, half, half);
+            bigint b2 = slice(b.digits, 0, half);
+            bigint a12 = slice(a.digits, half, a.digits.size());
+            bigint a1 = slice(a.digits, 2 * half, a.digits.size());
+            
+            // 用a的高两块除以b的高一块估算商
+            bigint r1;
+            if (a1 < b1)
+            {
+                bz_divide_2n_1n(a12, b1, half, q, r1);
+            }
+            else
+            {
+                // 商估计为BASE^half - 1
+                q = bigint(limb_vector(half, BASE - 1), false);
+                r1 = a12 - shift_limbs(b1, half) + b1;
+            }
+            
+            // 修正: 余数为负时加回除数, 最多两次
+            r = shift_limbs(r1, half) + slice(a.digits, 0, half) - q * b2;
+            while (r.is_negative)
+            {
+                r += b;
+                -- q;
+            }
+        }
+
+        // Burnikel-Ziegler递归除法(由divmod_digits在规模较大时调用)
+        static void bz_divmod(const limb_vector& a, const limb_vector& b,
+            limb_vector& quotient, limb_vector& remainder)
+        {
+            // 把除数补齐到n = j * 2^k个单元, j不超过阈值, 递归时每次减半
+            size_t s = b.size();
+            size_t blocks = 1;
+            while ((s + blocks - 1) / blocks > BZ_THRESHOLD) blocks *= 2;
+            size_t n = (s + blocks - 1) / blocks * blocks;
+            size_t pad = n - s;
+            
+            // 规格化: 除数最高单元不小于BASE / 2, 并在低位补pad个零单元
+            int d = BASE / (b.back() + 1);
+            bigint bn = shift_limbs(bigint(limb_vector(b), false) * d, pad);
+            bigint an = shift_limbs(bigint(limb_vector(a), false) * d, pad);
+            
+            // 被除数按n个单元分为t块, 最高块至少留一个零单元以保证小于除数
+            size_t t = std::max<size_t>(2, (an.digits.size() + n) / n);
+            
+            bigint z = slice(an.digits, (t - 2) * n, an.digits.size());
+            bigint qi, ri;
+            quotient.assign((t - 1) * n, 0);
+            for (size_t i = t - 1; i -- > 0; )
+            {
+                bz_divide_2n_1n(z, bn, n, qi, ri);
+                std::copy(qi.digits.begin(), qi.digits.end(), quotient.begin() + i * n);
+                if (i > 0)
+                {
+                    z = shift_limbs(ri, n) + slice(an.digits, (i - 1) * n, n);
+                }
+            }
+            
+            while (!quotient.empty() && quotient.back() == 0)
+            {
+                quotient.pop_back();
+            }
+            
+            // 还原余数: 去掉补上的零单元后除以规格化因子
+            remainder.clear();
+            if (!ri.is_zero()) remainder.assign(ri.digits.begin() + pad, ri.digits.end());
+            div_small(remainder, d);
+        }
+
+        // 不超过4个单元(小于10^36)的整数平方根, 作为递归平方根的基本情况
+        // 由高半部分的平方根得到初值, 再做一到两次牛顿迭代
+        static bigint isqrt_small(const bigint& n)
+        {
+            size_t len = n.digits.size();
+            if (len <= 2)
+            {
+                // 小于10^18, 直接用浮点数求值后修正
+                unsigned long long v = len > 0 ? static_cast<unsigned long long>(n.digits[0]) : 0;
+                if (len == 2) v += static_cast<unsigned long long>(n.digits[1]) * BASE;
+                unsigned long long r = static_cast<unsigned long long>(std::sqrt(static_cast<double>(v)));
+                while (r * r > v) -- r;
+                while ((r + 1) * (r + 1) <= v) ++ r;
+                return bigint(r);
+            }
+            
+            // n = h * BASE^(2m) + l, 由sqrt(h)得到初值(sqrt(h) + 1) * BASE^m >= sqrt(n)
+            size_t m = std::max<size_t>(1, len / 4);
+            bigint h = slice(n.digits, 2 * m, len);
+            bigint x = shift_limbs(isqrt_small(h) + 1, m);
+            
+            // 从上方逼近的牛顿迭代, 序列严格递减直到floor(sqrt(n))
+            while (true)
+            {
+                bigint y = x + n / x;
+                div_small(y.digits, 2);
+                if (y >= x) break;
+                x = std::move(y);
+            }
+            return x;
+        }
+
+        // Zimmermann递归平方根: 求s = floor(sqrt(a)), r = a - s * s, 要求a的最高单元不小于BASE / 4
+        // a = a3 * BASE^(3l) + a2 * BASE^(2l) + a1 * BASE^l + a0, 先递归求高半部分a3 * BASE^l + a2的平方根s'和余数r'
+        // 再由(r' * BASE^l + a1) / (2s')得到低半部分q, 精度每层翻倍, 总代价与一次同规模乘法同阶
+        static void sqrtrem_normalized(const bigint& a, bigint& s, bigint& r)
+        {
+            size_t n = a.digits.size();
+            size_t l = (n - 1) / 4;
+            if (l == 0)
+            {
+                s = isqrt_small(a);
+                r = a - s.square();
+                return;
+            }
+            
+            bigint high_root, high_rem;
+            sqrtrem_normalized(slice(a.digits, 2 * l, n), high_root, high_rem);
+            
+            // 最高单元规格化保证2s' >= BASE^l, q最多比真值大1
+            auto [q, u] = divmod(shift_limbs(std::move(high_rem), l) + slice(a.digits, l, l), high_root * 2);
+            s = shift_limbs(std::move(high_root), l) + q;
+            r = shift_limbs(std::move(u), l) + slice(a.digits, 0, l) - q.square();
+            while (r.is_negative)
+            {
+                r += s * 2 - 1;
+                -- s;
+            }
+        }
+
+        // 非负整数的整数平方根(向下取整), 余数写入remainder
+        // 最高单元小于BASE / 4时先乘以d^2规格化, 算出sqrt(n * d^2)后除以d, 再用平方求出余数
+        static bigint isqrt_abs(const bigint& n, bigint& remainder)
+        {
+            if (n.digits.size() <= 4)
+            {
+                bigint s = isqrt_small(n);
+                remainder = n - s.square();
+                return s;
+            }
+            
+            // 取最小的d使top * d^2 >= BASE / 4, 此时乘积不会进位到新的单元
+            long long top = n.digits.back();
+            int d = static_cast<int>(std::ceil(std::sqrt(BASE / (4.0 * top))));
+            while (d > 1 && 4 * top * (d - 1) * (d - 1) >= BASE) -- d;
+            while (4 * top * d * d < BASE) ++ d;
+            
+            bigint s;
+            if (d == 1)
+            {
+                sqrtrem_normalized(n, s, remainder);
+                return s;
+            }
+            bigint scaled = n;
+            mul_small(scaled.digits, d * d);
+            sqrtrem_normalized(scaled, s, remainder);
+            div_small(s.digits, d);
+            s.trim();
+            remainder = n - s.square();
+            return s;
+        }
+
+        // 64位整数的二进制GCD
+        static unsigned long long binary_gcd(unsigned long long a, unsigned long long b) noexcept
+        {
+            if (a == 0) return b;
+            if (b == 0) return a;
+            int shift = std::countr_zero(a | b);
+            a >>= std::countr_zero(a);
+            while (b != 0)
+            {
+                b >>= std::countr_zero(b);
+                if (a > b) std::swap(a, b);
+                b -= a;
+            }
+            return a << shift;
+        }
+
+        // Lehmer步的线性组合: (u, v) = (A * u + B * v, C * u + D * v)
+        // 系数绝对值小于BASE, 且保证两个结果都非负
+        static void lehmer_combine(limb_vector& u, limb_vector& v, long long A, long long B, long long C, long long D)
+        {
+            size_t n = std::max(u.size(), v.size());
+            u.resize(n, 0);
+            v.resize(n, 0);
+            long long carry_u = 0, carry_v = 0;
+            for (size_t i = 0; i < n; ++ i)
+            {
+                long long cu = A * u[i] + B * v[i] + carry_u;
+                long long cv = C * u[i] + D * v[i] + carry_v;
+                carry_u = cu / BASE;
+                carry_v = cv / BASE;
+                cu %= BASE;
+                cv %= BASE;
+                if (cu < 0)
+                {
+                    cu += BASE;
+                    -- carry_u;
+                }
+                if (cv < 0)
+                {
+                    cv += BASE;
+                    -- carry_v;
+                }
+                u[i] = static_cast<int>(cu);
+                v[i] = static_cast<int>(cv);
+            }
+            for (; carry_u > 0; carry_u /= BASE) u.push_back(static_cast<int>(carry_u % BASE));
+            for (; carry_v > 0; carry_v /= BASE) v.push_back(static_cast<int>(carry_v % BASE));
+            while (!u.empty() && u.back() == 0) u.pop_back();
+            while (!v.empty() && v.back() == 0) v.pop_back();
+        }
+
+        // 两位数字查表, 输出时每次处理两位
+        static constexpr char DIGIT_PAIRS[201] =
+            "00010203040506070809"
+            "10111213141516171819"
+            "20212223242526272829"
+            "30313233343536373839"
+            "40414243444546474849"
+            "50515253545556575859"
+            "60616263646566676869"
+            "70717273747576777879"
+            "80818283848586878889"
+            "90919293949596979899";
+
+        // 将一个单元写成9个字符(补足前导零)
+        static void write_limb(char* out, int value) noexcept
+        {
+            for (int i = BASE_DIGITS - 2; i > 0; i -= 2)
+            {
+                int pair = value % 100;
+                value /= 100;
+                out[i] = DIGIT_PAIRS[2 * pair];
+                out[i + 1] = DIGIT_PAIRS[2 * pair + 1];
+            }
+            out[0] = static_cast<char>('0' + value);
+        }
+
+        // SWAR: 一次解析8个十进制字符, 含非数字字符时返回false
+        static bool parse_eight_digits(const char* p, int& value) noexcept
+        {
+            unsigned long long v;
+            std::memcpy(&v, p, sizeof(v));
+            
+            // 每个字节都在'0'~'9'之间时, 高4位为3且加6后不进位
+            if ((((v & 0xF0F0F0F0F0F0F0F0ULL) | (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+                != 0x3333333333333333ULL))
+            {
+                return false;
+            }
+            
+            // 依次合并相邻的1位, 2位, 4位数字
+            v = (v & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+            v = (v & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+            value = static_cast<int>((v & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32);
+            return true;
+        }
+
+        // 解析[first, last)中不超过9个字符为一个单元
+        static bool parse_limb(const char* first, const char* last, int& value) noexcept
+        {
+            value = 0;
+            if constexpr (std::endian::native == std::endian::little)
+            {
+                // 满9位时先解析首位, 剩下8位一次解析
+                if (last - first == BASE_DIGITS)
+                {
+                    if (!std::isdigit(static_cast<unsigned char>(*first))) return false;
+                    int low = 0;
+                    if (!parse_eight_digits(first + 1, low)) return false;
+                    value = (*first - '0') * 100000000 + low;
+                    return true;
+                }
+            }
+            for (; first != last; ++ first)
+            {
+                if (!std::isdigit(static_cast<unsigned char>(*first))) return false;
+                value = value * 10 + (*first - '0');
+            }
+            return true;
+        }
+
+        // 从单元数组构造(内部使用)
+        bigint(limb_vector&& d, bool neg) noexcept
+            : digits(std::move(d)), is_negative(neg)
+        {
+            trim();
+        }
+
+        // 绝对值加一(原地), 进位传递到不再进位为止
+        void increment_abs()
+        {
+            const int one = 1;
+            if (digits.empty() || add_in_place(digits.data(), digits.size(), &one, 1)) digits.push_back(1);
+        }
+
+        // 绝对值减一(原地), 要求绝对值不为零
+        void decrement_abs() noexcept
+        {
+            const int one = 1;
+            sub_in_place(digits.data(), digits.size(), &one, 1);
+            trim();
+        }
+
+        // b = a - b(原地), 要求a >= b, 两者都是n个单元
+        static void reverse_sub_in_place(const int* a, int* b, size_t n) noexcept
+        {
+            sub_n(a, b, b, n, 0);
+        }
+
+        // *this += (other_negative ? -|other| : |other|), 在自身的单元存储上完成
+        void add_signed(const bigint& other, bool other_negative)
+        {
+            size_t n = other.digits.size();
+            if (is_negative == other_negative)
+            {
+                // 同号: 绝对值相加
+                if (digits.size() < n) digits.resize(n, 0);
+                if (add_in_place(digits.data(), digits.size(), other.digits.data(), n)) digits.push_back(1);
+            }
+            else if (compare_abs(other) >= 0)
+            {
+                // 异号且|this| >= |other|: 符号不变, 绝对值相减
+                sub_in_place(digits.data(), digits.size(), other.digits.data(), n);
+                trim();
+            }
+            else
+            {
+                // 异号且|this| < |other|: 结果取other的符号, 绝对值为|other| - |this|
+                digits.resize(n, 0);
+                reverse_sub_in_place(other.digits.data(), digits.data(), n);
+                is_negative = other_negative;
+                trim();
+            }
+        }
+
+        // *this += (product_negative ? -|a * b| : |a * b|)
+        void multiply_accumulate(const bigint& a, const bigint& b, bool product_negative)
+        {
+            if (a.is_zero() || b.is_zero()) return;
+            
+            size_t na = a.digits.size(), nb = b.digits.size();
+            bool overlap = this == &a || this == &b;
+            if (std::min(na, nb) > KARATSUBA_THRESHOLD && is_zero() && !overlap)
+            {
+                // 自身为零时乘积直接写入自身的存储
+                multiply_digits(a.digits, b.digits, digits);
+                is_negative = product_negative;
+                trim();
+                return;
+            }
+            if (std::min(na, nb) > KARATSUBA_THRESHOLD || overlap)
+            {
+                // 规模较大或与乘数重叠时, 乘积写入线程局部缓冲区后再原地相加
+                // 缓冲区的容量不超过SCRATCH_KEEP_LIMIT时留作下一次使用, 否则用完即释放
+                static thread_local bigint product(bigint(), std::pmr::new_delete_resource());
+                multiply_digits(a.digits, b.digits, product.digits);
+                product.trim();
+                add_signed(product, product_negative);
+                if (product.digits.capacity() > SCRATCH_KEEP_LIMIT)
+                {
+                    product.digits.clear();
+                    product.digits.shrink_to_fit();
+                }
+                return;
+            }
+            
+            size_t len = na + nb;
+            if (is_negative == product_negative)
+            {
+                // 同号: 绝对值相加, 多留一个单元接收进位
+                if (digits.size() <= len) digits.resize(len + 1, 0);
+                int carry = addmul_n(digits.data(), a.digits.data(), na, b.digits.data(), nb, false);
+                for (size_t k = len; carry; ++ k)
+                {
+                    if (k == digits.size()) digits.push_back(0);
+                    int sum = digits[k] + carry;
+                    carry = sum == BASE;
+                    digits[k] = carry ? 0 : sum;
+                }
+            }
+            else
+            {
+                // 异号: 绝对值相减, 不够减时取补码并改变符号
+                if (digits.size() < len) digits.resize(len, 0);
+                int borrow = addmul_n(digits.data(), a.digits.data(), na, b.digits.data(), nb, true);
+                for (size_t k = len; borrow && k < digits.size(); ++ k)
+                {
+                    int diff = digits[k] - borrow;
+                    borrow = diff < 0;
+                    digits[k] = borrow ? BASE - 1 : diff;
+                }
+                if (borrow)
+                {
+                    // 此时存储中为结果加上BASE^size, 用0减去它得到结果的绝对值
+                    borrow = 0;
+                    for (int& limb : digits)
+                    {
+                        int diff = -limb - borrow;
+                        borrow = diff < 0;
+                        limb = borrow ? diff + BASE : diff;
+                    }
+                    is_negative = !is_negative;
+                }
+            }
+            trim();
+        }
+
+    public:
+        // 构造函数(零的单元为空, 不申请内存)
+        bigint() noexcept : is_negative(false) {}
+        
+        // 从字符串构造
+        bigint(const std::string& s)
+        {
+            if (s.empty())
+            {
+                is_negative = false;
+                return;
+            }
+            
+            size_t start = 0;
+            is_negative = false;
+            
+            // 处理符号
+            if (s[0] == '-')
+            {
+                is_negative = true;
+                start = 1;
+            }
+            else if (s[0] == '+')
+            {
+                start = 1;
+            }
+            
+            // 跳过前导零
+            while (start < s.size() && s[start] == '0')
+            {
+                start ++;
+            }
+            
+            if (start == s.size())
+            {
+                is_negative = false;
+                return;
+            }
+            
+            // 计算需要的digits数量
+            size_t num_digits = (s.size() - start + BASE_DIGITS - 1) / BASE_DIGITS;
+            digits.resize(num_digits, 0);
+            
+            // 从低位开始每9个字符解析为一个单元, 最高单元可能不足9位
+            const char* first = s.data() + start;
+            const char* p = s.data() + s.size();
+            for (size_t i = 0; i < num_digits; ++ i)
+            {
+                const char* from = std::max(first, p - BASE_DIGITS);
+                int value = 0;
+                if (!parse_limb(from, p, value))
+                {
+                    throw_inv_arg("Invalid character in argument of bigint constructor",
+                        "high_precision_digit.hpp", "class bigint(in constructor)", "ikun_bigint 001"
+                    );
+                }
+                digits[i] = value;
+                p = from;
+            }
+            
+            trim();
+        }
+        
+        // 从64位整数构造
+        bigint(long long n)
+        {
+            is_negative = n < 0;
+            unsigned long long un = abs_ll(n); // 直接对LLONG_MIN取abs会溢出
+            
+            while (un > 0)
+            {
+                digits.push_back(static_cast<int>(un % BASE));
+                un /= BASE;
+            }
+        }
+        
+        // 从vector构造(10^9进制, 低位在前)
+        // 单元存储是limb_vector, 无法接管vector的内存, 所以只提供复制的版本; 需要检查单元范围时使用from_limbs()
+        explicit bigint(const std::vector<int>& d, bool neg = false)
+            : digits(d.data(), d.data() + d.size()), is_negative(neg)
+        {
+            trim();
+        }
+        
+        // 移动构造函数
+        bigint(bigint&& other) noexcept
+            : digits(std::move(other.digits)), is_negative(other.is_negative)
+        {
+            other.is_negative = false; // 移动后other的单元为空, 即为零
+        }
+        
+        // 复制构造函数(使用当前的内存资源)
+        bigint(const bigint& other) = default;
+        
+        // 复制到指定的内存资源上, 例如把内存池中算出的结果复制到全局堆上保留
+        bigint(const bigint& other, std::pmr::memory_resource* resource)
+            : digits(resource), is_negative(other.is_negative)
+        {
+            digits.assign(other.digits.begin(), other.digits.end());
+        }
+
+        // 便捷构造函数
+        bigint(int n) : bigint(static_cast<long long>(n)) {}
+        bigint(unsigned int n) : bigint(static_cast<long long>(n)) {}
+        bigint(unsigned long long n) : is_negative(false)
+        {
+            while (n > 0)
+            {
+                digits.push_back(static_cast<int>(n % BASE));
+                n /= BASE;
+            }
+        }
+
+        // 从字符指针构造
+        bigint(const char* s) : bigint(std::string(s)) {}
+        
+        // 移动赋值运算符
+        // 两者的内存资源不同时会复制单元(见limb_vector的移动赋值), 可能抛出异常, 所以不声明noexcept
+        bigint& operator=(bigint&& other)
+        {
+            if (this != &other)
+            {
+                digits = std::move(other.digits);
+                is_negative = other.is_negative;
+                other.is_negative = false;
+            }
+            return *this;
+        }
+        
+        // 复制赋值运算符
+        bigint& operator=(const bigint& other) = default;
+        
+        // 转换为字符串
+        std::string to_string() const
+        {
+            if (digits.empty()) return "0";
+            
+            // 最高位不需要前导零, 其余位需要补足9位, 一次性分配好整个字符串
+            int top = digits.back();
+            size_t top_len = 1;
+            for (int t = top; t >= 10; t /= 10) ++ top_len;
+            
+            std::string result(is_negative + top_len + (digits.size() - 1) * BASE_DIGITS, '0');
+            char* p = result.data() + result.size();
+            for (size_t i = 0; i + 1 < digits.size(); ++ i)
+            {
+                p -= BASE_DIGITS;
+                write_limb(p, digits[i]);
+            }
+            
+            for (; top >= 10; top /= 10)
+            {
+                *-- p = static_cast<char>('0' + top % 10);
+            }
+            *-- p = static_cast<char>('0' + top);
+            if (is_negative) result[0] = '-';
+            
+            return result;
+        }
+        
+        // 算术运算符
+        bigint operator+(const bigint& other) const
+        {
+            // 同号相加
+            if (is_negative == other.is_negative)
+            {
+                bigint result;
+                add_abs(*this, other, result);
+                result.is_negative = is_negative;
+                return result;
+            }
+            
+            // 异号相减
+            int cmp = compare_abs(other);
+            if (cmp == 0) return bigint(0);
+            
+            bigint result;
+            if (cmp > 0)
+            {
+                sub_abs(*this, other, result);
+                result.is_negative = is_negative;
+            }
+            else
+            {
+                sub_abs(other, *this, result);
+                result.is_negative = other.is_negative;
+            }
+            
+            return result;
+        }
+        
+        // 复合赋值运算符(直接在自身的单元存储上运算)
+        bigint& operator+=(const bigint& other)
+        {
+            add_signed(other, other.is_negative);
+            return *this;
+        }
+        
+        bigint operator-(const bigint& other) const
+        {
+            // 改变符号后相加
+            bigint temp = other;
+            temp.is_negative = !temp.is_negative;
+            return *this + temp;
+        }
+        
+        bigint& operator-=(const bigint& other)
+        {
+            add_signed(other, !other.is_negative);
+            return *this;
+        }
+        
+        // 乘法(自动选择算法)
+        bigint operator*(const bigint& other) const
+        {
+            bigint result;
+            result.is_negative = is_negative != other.is_negative;
+            
+            // 如果有一个是0, 直接返回0
+            if (is_zero() || other.is_zero())
+            {
+                return bigint();
+            }
+            
+            // 根据规模选择乘法算法: 朴素 -> Karatsuba -> Toom-3 -> Toom-4 -> NTT
+            multiply_digits(digits, other.digits, result.digits);
+            
+            result.trim();
+            return result;
+        }
+        
+        bigint& operator*=(const bigint& other)
+        {
+            // 乘积写入线程局部缓冲区后与自身交换, 换下来的旧存储留作下一次的缓冲区, 容量不超过SCRATCH_KEEP_LIMIT时得以复用
+            // 缓冲区固定使用全局堆, 自身在其他内存资源上时只能复制
+            static thread_local limb_vector buffer(std::pmr::new_delete_resource());
+            multiply_digits(digits, other.digits, buffer);
+            if (digits.same_resource(buffer)) std::swap(digits, buffer);
+            else digits.assign(buffer.begin(), buffer.end());
+            is_negative = is_negative != other.is_negative;
+            trim();
+            
+            // 不长期占用大乘积的内存, 一次特别大的乘法之后缓冲区恢复为空
+            if (buffer.capacity() > SCRATCH_KEEP_LIMIT)
+            {
+                buffer.clear();
+                buffer.shrink_to_fit();
+            }
+            return *this;
+        }
+        
+        // 乘加: *this += a * b, 较短的乘数不超过KARATSUBA_THRESHOLD时直接累加到自身的存储上, 不生成乘积
+        bigint& addmul(const bigint& a, const bigint& b)
+        {
+            multiply_accumulate(a, b, a.is_negative != b.is_negative);
+            return *this;
+        }
+        
+        // 乘减: *this -= a * b
+        bigint& submul(const bigint& a, const bigint& b)
+        {
+            multiply_accumulate(a, b, a.is_negative == b.is_negative);
+            return *this;
+        }
+        
+        // 从惰性表达式构造/赋值/累加, 直接在自身的存储上逐项求值
+        template <bigint_expression Expr>
+        bigint(const Expr& e) : bigint()
+        {
+            e.accumulate(*this, false);
+        }
+        
+        template <bigint_expression Expr>
+        bigint& operator=(const Expr& e)
+        {
+            if (e.refers_to(this)) return *this = bigint(e);
+            digits.clear();
+            is_negative = false;
+            e.accumulate(*this, false);
+            return *this;
+        }
+        
+        template <bigint_expression Expr>
+        bigint& operator+=(const Expr& e)
+        {
+            if (e.refers_to(this)) return *this += bigint(e);
+            e.accumulate(*this, false);
+            return *this;
+        }
+        
+        template <bigint_expression Expr>
+        bigint& operator-=(const Expr& e)
+        {
+            if (e.refers_to(this)) return *this -= bigint(e);
+            e.accumulate(*this, true);
+            return *this;
+        }
+        
+        // 带余除法: 一次除法同时得到商和余数
+        // 商向零取整, 余数与被除数同号, 满足a == q * b + r
+        friend std::pair<bigint, bigint> divmod(const bigint& a, const bigint& b)
+        {
+            if (b.is_zero())
+            {
+                throw_re("Division by zero",
+                    "high_precision_digit.hpp", "class bigint in divmod()", "ikun_bigint 002"
+                );
+            }
+            
+            std::pair<bigint, bigint> result;
+            divmod_digits(a.digits, b.digits, result.first.digits, result.second.digits);
+            result.first.is_negative = a.is_negative != b.is_negative;
+            result.second.is_negative = a.is_negative;
+            result.first.trim();
+            result.second.trim();
+            return result;
+        }
+        
+        // 除数为64位整数的带余除法, 语义同上, 余数直接以long long返回
+        friend std::pair<bigint, long long> divmod(const bigint& a, long long b)
+        {
+            if (b == 0)
+            {
+                throw_re("Division by zero",
+                    "high_precision_digit.hpp", "class bigint in divmod()", "ikun_bigint 002"
+                );
+            }
+            
+            std::pair<bigint, long long> result;
+            unsigned long long ub = abs_ll(b);
+            unsigned long long rem = 0;
+            if (ub < static_cast<unsigned long long>(BASE))
+            {
+                result.first.digits = a.digits;
+                rem = static_cast<unsigned long long>(div_small(result.first.digits, static_cast<int>(ub)));
+            }
+            else
+            {
+                // 余数的绝对值小于|b|, 最多3个单元
+                bigint remainder;
+                divmod_digits(a.digits, bigint(b).digits, result.first.digits, remainder.digits);
+                for (size_t i = remainder.digits.size(); i -- > 0; )
+                {
+                    rem = rem * BASE + static_cast<unsigned long long>(remainder.digits[i]);
+                }
+            }
+            result.first.is_negative = a.is_negative != (b < 0);
+            result.first.trim();
+            result.second = a.is_negative ? -static_cast<long long>(rem) : static_cast<long long>(rem);
+            return result;
+        }
+        
+        // 除法(向零取整)
+        bigint operator/(const bigint& other) const
+        {
+            return divmod(*this, other).first;
+        }
+        
+        bigint& operator/=(const bigint& other)
+        {
             *this = *this / other;
             return *this;
         }
-        
-        bigint operator%(const bigint& other) const
+        
+        // 取模(结果非负)
+        bigint operator%(const bigint& other) const
+        {
+            if (other.is_zero())
+            {
+                throw_re("Modulo by zero",
+                    "high_precision_digit.hpp", "class bigint in operator%", "ikun_bigint 003"
+                );
+            }
+            
+            bigint remainder = std::move(divmod(*this, other).second);
+            
+            // 确保余数非负: 余数为负时取|other| - |余数|
+            if (remainder.is_negative)
+            {
+                bigint result;
+                sub_abs(other, remainder, result);
+                return result;
+            }
+            
+            return remainder;
+        }
+        
+        bigint& operator%=(const bigint& other)
+        {
+            *this = *this % other;
+            return *this;
+        }
+        
+        // 平方(交叉项只计算一次, 比一般乘法快)
+        bigint square() const
+        {
+            bigint result;
+            square_digits(digits, result.digits);
+            result.trim();
+            return result;
+        }
+        
+        // 快速幂运算
+        bigint pow(int exponent) const
+        {
+            if (exponent < 0)
+            {
+                throw_re("Negative exponent not supported for integers",
+                    "high_precision_digit.hpp", "class bigint in pow()", "ikun_bigint 004"
+                );
+            }
+            
+            if (exponent == 0) return bigint(1);
+            
+            bigint result(1);
+            bigint base = *this;
+            
+            while (exponent > 0)
+            {
+                if (exponent & 1)
+                {
+                    result *= base;
+                }
+                exponent >>= 1;
+                if (exponent > 0) base = base.square();
+            }
+            
+            return result;
+        }
+        
+        // 比较运算符
+        bool operator==(const bigint& other) const noexcept
+        {
+            return is_negative == other.is_negative && digits == other.digits;
+        }
+        
+        bool operator!=(const bigint& other) const noexcept
+        {
+            return !(*this == other);
+        }
+        
+        bool operator<(const bigint& other) const noexcept
+        {
+            if (is_negative != other.is_negative)
+            {
+                return is_negative;
+            }
+            
+            if (is_negative)
+            {
+                return compare_abs(other) > 0;
+            }
+            else
+            {
+                return compare_abs(other) < 0;
+            }
+        }
+        
+        bool operator<=(const bigint& other) const noexcept
+        {
+            return *this < other || *this == other;
+        }
+        
+        bool operator>(const bigint& other) const noexcept
+        {
+            return !(*this <= other);
+        }
+        
+        bool operator>=(const bigint& other) const noexcept
+        {
+            return !(*this < other);
+        }
+        
+        // 前置和后置递增递减
+        bigint& operator++()  // 前置++
+        {
+            if (is_negative)
+            {
+                decrement_abs();
+            }
+            else
+            {
+                increment_abs();
+            }
+            return *this;
+        }
+        
+        bigint operator++(int)  // 后置++
+        {
+            bigint temp = *this;
+            ++(*this);
+            return temp;
+        }
+        
+        bigint& operator--()  // 前置--
+        {
+            if (is_negative)
+            {
+                increment_abs();
+            }
+            else if (is_zero())
+            {
+                digits.push_back(1);
+                is_negative = true;
+            }
+            else
+            {
+                decrement_abs();
+            }
+            return *this;
+        }
+        
+        bigint operator--(int)  // 后置--
+        {
+            bigint temp = *this;
+            --(*this);
+            return temp;
+        }
+        
+        // 位运算运算符
+        // 移位: 10^9进制下移位就是乘除2的幂
+        // 位移不大时按2^29一组逐单元乘除(每组扫描一遍)
+        // 位移较大时先用平方求出2^shift(代价约为一次shift / 30个单元的乘法), 再做一次乘法或除法
+        // 左移的代价与结果的规模同阶; 右移超过总位数时直接得0, 所以2^shift和除法都不超过操作数的规模
+        bigint& operator<<=(int shift)  // 左移相当于乘以2^shift
+        {
+            if (shift < 0)
+            {
+                // -INT_MIN会溢出, 分两次移位
+                if (shift == std::numeric_limits<int>::min())
+                {
+                    *this >>= std::numeric_limits<int>::max();
+                    return *this >>= 1;
+                }
+                return *this >>= -shift;
+            }
+            if (is_zero()) return *this;
+            
+            if (shift <= SHIFT_WORDS * WORD_SHIFT)
+            {
+                for (; shift > 0; shift -= WORD_SHIFT)
+                {
+                    mul_small(digits, 1 << std::min(shift, WORD_SHIFT));
+                }
+            }
+            else
+            {
+                *this *= bigint(2).pow(shift);
+            }
+            return *this;
+        }
+        
+        bigint& operator>>=(int shift)  // 右移相当于除以2^shift(向零取整)
+        {
+            if (shift < 0)
+            {
+                if (shift == std::numeric_limits<int>::min())
+                {
+                    *this <<= std::numeric_limits<int>::max();
+                    return *this <<= 1;
+                }
+                return *this <<= -shift;
+            }
+            if (is_zero()) return *this;
+            
+            // 每个单元不足30位, 位移超过总位数时结果为0
+            if (static_cast<size_t>(shift) >= digits.size() * 30)
+            {
+                *this = bigint(0);
+            }
+            else if (shift <= SHIFT_WORDS * WORD_SHIFT)
+            {
+                for (; shift > 0; shift -= WORD_SHIFT)
+                {
+                    div_small(digits, 1 << std::min(shift, WORD_SHIFT));
+                }
+                trim();
+            }
+            else
+            {
+                *this = *this / bigint(2).pow(shift);
+            }
+            return *this;
+        }
+        
+        bigint operator<<(int shift) const
+        {
+            bigint result = *this;
+            result <<= shift;
+            return result;
+        }
+        
+        bigint operator>>(int shift) const
+        {
+            bigint result = *this;
+            result >>= shift;
+            return result;
+        }
+        
+        // 与整数类型的运算(绝对值小于BASE时使用单元级的快速算法, 否则转换为大数后计算, 转换不申请内存)
+        bigint operator+(long long n) const
+        {
+            bigint result = *this;
+            result += n;
+            return result;
+        }
+        
+        bigint operator-(long long n) const
+        {
+            bigint result = *this;
+            result -= n;
+            return result;
+        }
+        
+        bigint operator*(long long n) const
+        {
+            bigint result = *this;
+            result *= n;
+            return result;
+        }
+        
+        bigint operator/(long long n) const 
+        {
+            bigint result = *this;
+            result /= n;
+            return result;
+        }
+        
+        bigint operator%(long long n) const
+        {
+            unsigned long long un = abs_ll(n);
+            if (n == 0 || un >= static_cast<unsigned long long>(BASE))
+            {
+                return *this % bigint(n);
+            }
+            
+            // 只求余数, 不生成商; 余数取非负值
+            int rem = mod_small(digits, static_cast<int>(un));
+            if (is_negative && rem != 0) rem = static_cast<int>(un) - rem;
+            return bigint(rem);
+        }
+        
+        bigint& operator+=(long long n)
+        {
+            add_signed(bigint(n), n < 0);
+            return *this;
+        }
+        
+        bigint& operator-=(long long n)
+        {
+            add_signed(bigint(n), n >= 0);
+            return *this;
+        }
+        
+        bigint& operator*=(long long n)
+        {
+            unsigned long long un = abs_ll(n);
+            if (un >= static_cast<unsigned long long>(BASE))
+            {
+                return *this *= bigint(n);
+            }
+            
+            mul_small(digits, static_cast<int>(un));
+            is_negative = is_negative != (n < 0);
+            trim();
+            return *this;
+        }
+        
+        bigint& operator/=(long long n)
+        {
+            unsigned long long un = abs_ll(n);
+            if (n == 0 || un >= static_cast<unsigned long long>(BASE))
+            {
+                return *this = *this / bigint(n);
+            }
+            
+            div_small(digits, static_cast<int>(un));
+            is_negative = is_negative != (n < 0);
+            trim();
+            return *this;
+        }
+        
+        bigint& operator%=(long long n)
+        {
+            *this = *this % n;
+            return *this;
+        }
+        
+        // 友元函数，支持整数在左侧的运算
+        friend bigint operator+(long long n, const bigint& b)
+        {
+            return b + n;
+        }
+        
+        friend bigint operator-(long long n, const bigint& b)
+        {
+            return bigint(n) - b;
+        }
+        
+        friend bigint operator*(long long n, const bigint& b)
+        {
+            return b * n;
+        }
+        
+        friend bigint operator/(long long n, const bigint& b)
+        {
+            return bigint(n) / b;
+        }
+        
+        friend bigint operator%(long long n, const bigint& b)
+        {
+            return bigint(n) % b;
+        }
+        
+        // 数学函数
+        friend bigint abs(const bigint& n)
+        {
+            bigint result = n;
+            result.is_negative = false;
+            return result;
+        }
+        
+        // 整数平方根(向下取整)
+        friend bigint sqrt(const bigint& n)
+        {
+            if (n.is_negative)
+            {
+                throw_re("Square root of negative number",
+                    "high_precision_digit.hpp", "class bigint in sqrt()", "ikun_bigint 005"
+                );
+            }
+            
+            bigint remainder;
+            return isqrt_abs(n, remainder);
+        }
+        
+        // 整数平方根及余数: 返回(s, r), 满足n == s * s + r且0 <= r <= 2s
+        friend std::pair<bigint, bigint> sqrtrem(const bigint& n)
+        {
+            if (n.is_negative)
+            {
+                throw_re("Square root of negative number",
+                    "high_precision_digit.hpp", "class bigint in sqrtrem()", "ikun_bigint 005"
+                );
+            }
+            
+            std::pair<bigint, bigint> result;
+            result.first = isqrt_abs(n, result.second);
+            return result;
+        }
+        
+        // 最大公因数(Lehmer算法, 结果非负)
+        // 用两数最高两个单元模拟欧几里得算法, 累积成一组不超过一个单元的系数后一次性作用到整个数上
+        // 模拟无法推进(商过大)时做一次完整的带余除法, 两数都不超过两个单元后改用64位二进制GCD
+        bigint gcd(const bigint& other) const
+        {
+            bigint a = abs(*this), b = abs(other);
+            if (a < b) std::swap(a, b);
+            
+            while (!b.is_zero())
+            {
+                size_t n = a.digits.size();
+                if (n <= 2)
+                {
+                    auto value = [](const bigint& x)
+                    {
+                        unsigned long long v = static_cast<unsigned long long>(x.digits[0]);
+                        if (x.digits.size() > 1) v += static_cast<unsigned long long>(x.digits[1]) * BASE;
+                        return v;
+                    };
+                    return bigint(binary_gcd(value(a), value(b)));
+                }
+                
+                long long A = 1, B = 0, C = 0, D = 1;
+                if (n - b.digits.size() <= 1)
+                {
+                    // 对齐到a的最高两个单元
+                    long long x = static_cast<long long>(a.digits[n - 1]) * BASE + a.digits[n - 2];
+                    long long y = b.digits[n - 2];
+                    if (b.digits.size() == n) y += static_cast<long long>(b.digits[n - 1]) * BASE;
+                    
+                    while (y + C > 0 && y + D > 0)
+                    {
+                        long long q = (x + A) / (y + C);
+                        if (q != (x + B) / (y + D) || q >= BASE) break;
+                        long long nA = C, nB = D, nC = A - q * C, nD = B - q * D;
+                        if (std::abs(nC) >= BASE || std::abs(nD) >= BASE) break;
+                        A = nA;
+                        B = nB;
+                        C = nC;
+                        D = nD;
+                        long long t = x - q * y;
+                        x = y;
+                        y = t;
+                    }
+                }
+                
+                if (B == 0)
+                {
+                    bigint q, r;
+                    divmod_digits(a.digits, b.digits, q.digits, r.digits);
+                    a = std::move(b);
+                    b = std::move(r);
+                    b.trim();
+                }
+                else
+                {
+                    lehmer_combine(a.digits, b.digits, A, B, C, D);
+                }
+            }
+            return a;
+        }
+        
+        // 加减法和比较使用的指令集: 默认为CPU支持的最高级别, 只能调低(例如用于对比测试), 调高时取CPU支持的级别
+        static void set_simd_level(simd_level level) noexcept
+        {
+            simd_level supported = detect_simd();
+            simd_state().store(level > supported ? supported : level, std::memory_order_relaxed);
+        }
+        
+        static simd_level get_simd_level() noexcept
+        {
+            return simd_state().load(std::memory_order_relaxed);
+        }
+        
+        // 超大规模乘法(NTT)使用的线程数上限, 默认为1(单线程), 0表示CPU核心数; 结果与线程数无关
+        // 辅助线程来自常驻的线程池, 修改线程数时停止原有的线程, 下次需要并行时按新的数量启动
+        static void set_thread_count(unsigned count)
+        {
+            if (count == 0) count = std::max(1u, std::thread::hardware_concurrency());
+            thread_limit().store(count, std::memory_order_relaxed);
+            pool().stop();
+        }
+        
+        static unsigned get_thread_count() noexcept
+        {
+            return thread_limit().load(std::memory_order_relaxed);
+        }
+        
+        // 实用函数
+        size_t get_digit_count() const noexcept
+        {
+            if (digits.empty()) return 1; // 零占一位
+            size_t count = (digits.size() - 1) * BASE_DIGITS;
+            int last = digits.back();
+            while (last > 0)
+            {
+                count ++;
+                last /= 10;
+            }
+            return count == 0 ? 1 : count;
+        }
+        
+        bool is_zero() const noexcept
+        {
+            return digits.empty();
+        }
+        
+        bool is_odd() const noexcept
+        {
+            return !digits.empty() && (digits[0] & 1) == 1;
+        }
+        
+        bool is_even() const noexcept
+        {
+            return digits.empty() || (digits[0] & 1) == 0;
+        }
+        
+        // 单元存储所在的内存资源
+        std::pmr::memory_resource* get_resource() const noexcept
+        {
+            return digits.resource();
+        }
+        
+        // 符号: 负数为-1, 零为0, 正数为1
+        int sign() const noexcept
+        {
+            return digits.empty() ? 0 : (is_negative ? -1 : 1);
+        }
+        
+        // 导出绝对值的单元(10^9进制, 低位在前, 零为空), 不复制, 符号用sign()取得
+        std::span<const int> limbs() const noexcept
+        {
+            return std::span<const int>(digits.data(), digits.size());
+        }
+        
+        // 从单元导入(与limbs()的格式相同), 每个单元必须在[0, 10^9)内, 高位的零会被去掉
+        static bigint from_limbs(std::span<const int> limbs, bool negative = false)
+        {
+            for (int limb : limbs)
+            {
+                if (limb < 0 || limb >= BASE)
+                {
+                    throw_inv_arg("Limb out of range [0, 10^9) in bigint::from_limbs()",
+                        "high_precision_digit.hpp", "class bigint in from_limbs()", "ikun_bigint 012"
+                    );
+                }
+            }
+            return bigint(limb_vector(limbs.data(), limbs.data() + limbs.size()), negative);
+        }
+        
+        // 在当前线程内把此后新建的bigint的单元存储放到resource上, 离开作用域时恢复
+        // 例如每批计算使用一个std::pmr::monotonic_buffer_resource, 结束时整体释放, 不再逐个释放中间结果
+        // 作用域内新建的bigint不能在resource销毁后继续使用, 需要保留的结果用bigint(x, 其他资源)复制出来
+        // 只影响当前线程, 多线程乘法的辅助线程仍使用默认资源
+        class memory_scope
+        {
+        public:
+            explicit memory_scope(std::pmr::memory_resource* resource) noexcept
+                : previous(limb_vector::scoped_resource())
+            {
+                limb_vector::scoped_resource() = resource;
+            }
+            
+            ~memory_scope()
+            {
+                limb_vector::scoped_resource() = previous;
+            }
+            
+            memory_scope(const memory_scope&) = delete;
+            memory_scope& operator=(const memory_scope&) = delete;
+            
+        private:
+            std::pmr::memory_resource* previous;
+        };
+        
+        // 交换函数, 两者的内存资源相同时不会抛出异常
+        void swap(bigint& other)
+        {
+            std::swap(digits, other.digits);
+            std::swap(is_negative, other.is_negative);
+        }
+
+        // 获取对象占用的总内存(包括动态分配的digits数组)
+        size_t get_size() const noexcept
+        {
+            // 对象自身大小(包括内联存储)
+            size_t total = sizeof(*this);
+            
+            // 加上digits动态分配的内存(内联存储时没有)
+            if (!digits.is_inline()) total += digits.capacity() * sizeof(int);
+            
+            // 注意：堆内存可能有额外的管理开销，这里只是估算
+            return total;
+        }
+    
+        // 与整数的比较(直接比较单元, 不构造临时大数)
+        bool operator==(long long n) const noexcept
+        {
+            return compare_ll(n) == 0;
+        }
+
+        bool operator!=(long long n) const noexcept
+        {
+            return compare_ll(n) != 0;
+        }
+
+        bool operator<(long long n) const noexcept
+        {
+            return compare_ll(n) < 0;
+        }
+
+        bool operator<=(long long n) const noexcept
+        {
+            return compare_ll(n) <= 0;
+        }
+
+        bool operator>(long long n) const noexcept
+        {
+            return compare_ll(n) > 0;
+        }
+
+        bool operator>=(long long n) const noexcept
+        {
+            return compare_ll(n) >= 0;
+        }
+
+        friend bool operator==(long long lhs, const bigint& rhs) noexcept
+        {
+            return rhs.compare_ll(lhs) == 0;
+        }
+
+        friend bool operator!=(long long lhs, const bigint& rhs) noexcept
+        {
+            return rhs.compare_ll(lhs) != 0;
+        }
+
+        friend bool operator<(long long lhs, const bigint& rhs) noexcept
+        {
+            return rhs.compare_ll(lhs) > 0;
+        }
+
+        friend bool operator<=(long long lhs, const bigint& rhs) noexcept
+        {
+            return rhs.compare_ll(lhs) >= 0;
+        }
+
+        friend bool operator>(long long lhs, const bigint& rhs) noexcept
+        {
+            return rhs.compare_ll(lhs) < 0;
+        }
+
+        friend bool operator>=(long long lhs, const bigint& rhs) noexcept
+        {
+            return rhs.compare_ll(lhs) <= 0;
+        }
+
+        // 添加类型转换运算符
+        operator std::string() const
+        {
+            return to_string();
+        }
+
+        // 与字符串的比较
+        bool operator==(const std::string& s) const
+        {
+            return *this == bigint(s);
+        }
+
+        bool operator!=(const std::string& s) const
+        {
+            return *this != bigint(s);
+        }
+
+        // 转换为整数类型
+        long long to_long_long() const
+        {
+            if (*this > bigint(std::numeric_limits<long long>::max()) ||
+                *this < bigint(std::numeric_limits<long long>::min()))
+                {
+                throw_out_of_range("bigint value out of long long range\n" + string(color::cyan) +
+                    "        Note: If you use the to_int() function, this error may also be triggered, because the to_int() function depends on the to_long_long() function.\n",
+                    "high_precision_digit.hpp", "class bigint in to_long_long()", "ikun_bigint 007");
+            }
+            
+            long long result = 0;
+            long long multiplier = 1;
+            
+            for (size_t i = 0; i < digits.size(); ++ i)
+            {
+                result += static_cast<long long>(digits[i]) * multiplier;
+                multiplier *= BASE;
+            }
+            
+            return is_negative ? -result : result;
+        }
+
+        int to_int() const
+        {
+            long long val = to_long_long();
+            if (val > std::numeric_limits<int>::max() || 
+                val < std::numeric_limits<int>::min())
+                {
+                throw_out_of_range("bigint value out of int range",
+                    "high_precision_digit.hpp", "class bigint in to_int()", "ikun_bigint 008");
+                }
+            return static_cast<int>(val);
+        }
+    };
+
+    // 惰性乘积a * b, 只保存两个乘数的引用
+    class product_expr
+    {
+    public:
+        product_expr(const bigint& a, const bigint& b) noexcept : a(a), b(b) {}
+        
+        void accumulate(bigint& x, bool negate) const
+        {
+            if (negate) x.submul(a, b);
+            else x.addmul(a, b);
+        }
+        
+        bool refers_to(const bigint* p) const noexcept
+        {
+            return p == &a || p == &b;
+        }
+        
+    private:
+        const bigint& a;
+        const bigint& b;
+    };
+    
+    // 表达式中的普通大数项
+    class operand_expr
+    {
+    public:
+        operand_expr(const bigint& v) noexcept : v(v) {}
+        
+        void accumulate(bigint& x, bool negate) const
+        {
+            if (negate) x -= v;
+            else x += v;
+        }
+        
+        bool refers_to(const bigint* p) const noexcept
+        {
+            return p == &v;
+        }
+        
+    private:
+        const bigint& v;
+    };
+    
+    // 两个表达式的和(subtract为true时为差)
+    template <typename L, typename R>
+    class sum_expr
+    {
+    public:
+        sum_expr(const L& left, const R& right, bool subtract) noexcept : left(left), right(right), subtract(subtract) {}
+        
+        void accumulate(bigint& x, bool negate) const
+        {
+            left.accumulate(x, negate);
+            right.accumulate(x, negate != subtract);
+        }
+        
+        bool refers_to(const bigint* p) const noexcept
+        {
+            return left.refers_to(p) || right.refers_to(p);
+        }
+        
+    private:
+        L left;
+        R right;
+        bool subtract;
+    };
+    
+    // 惰性乘法: 与+, -组合成表达式, 赋值给bigint时乘积项通过addmul/submul直接累加到目标上, 不产生中间结果
+    // 例如x = mul(a, b) + mul(c, d) - e; 表达式只保存操作数的引用, 不要用auto保存到完整表达式之外
+    inline product_expr mul(const bigint& a, const bigint& b) noexcept
+    {
+        return product_expr(a, b);
+    }
+    
+    inline operand_expr as_expression(const bigint& v) noexcept
+    {
+        return operand_expr(v);
+    }
+    
+    template <bigint_expression E>
+    const E& as_expression(const E& e) noexcept
+    {
+        return e;
+    }
+    
+    // 至少一侧是表达式, 另一侧是表达式或bigint时才组合成新表达式, bigint之间的运算仍然立即求值
+    template <typename L, typename R>
+    concept expression_operands = (bigint_expression<L> || bigint_expression<R>)
+        && (bigint_expression<L> || std::same_as<L, bigint>)
+        && (bigint_expression<R> || std::same_as<R, bigint>);
+    
+    template <typename L, typename R>
+        requires expression_operands<L, R>
+    auto operator+(const L& l, const R& r) noexcept
+    {
+        using left_type = std::decay_t<decltype(as_expression(l))>;
+        using right_type = std::decay_t<decltype(as_expression(r))>;
+        return sum_expr<left_type, right_type>(as_expression(l), as_expression(r), false);
+    }
+    
+    template <typename L, typename R>
+        requires expression_operands<L, R>
+    auto operator-(const L& l, const R& r) noexcept
+    {
+        using left_type = std::decay_t<decltype(as_expression(l))>;
+        using right_type = std::decay_t<decltype(as_expression(r))>;
+        return sum_expr<left_type, right_type>(as_expression(l), as_expression(r), true);
+    }
+
+    // 只读的大数视图, 单元存放在外部(例如bigint_archive映射的文件中), 视图不拥有也不复制这些单元
+    class bigint_view
+    {
+    private:
+        const int* ptr = nullptr;
+        size_t len = 0;
+        bool negative = false;
+
+    public:
+        bigint_view() noexcept = default;
+        
+        bigint_view(std::span<const int> limbs, bool neg) noexcept
+            : ptr(limbs.data()), len(limbs.size()), negative(neg && !limbs.empty()) {}
+        
+        bigint_view(const bigint& n) noexcept
+            : bigint_view(n.limbs(), n.sign() < 0) {}
+        
+        std::span<const int> limbs() const noexcept
+        {
+            return std::span<const int>(ptr, len);
+        }
+        
+        size_t size() const noexcept
+        {
+            return len;
+        }
+        
+        bool is_negative() const noexcept
+        {
+            return negative;
+        }
+        
+        bool is_zero() const noexcept
+        {
+            return len == 0;
+        }
+        
+        // 复制为bigint(会检查单元范围)
+        bigint to_bigint() const
+        {
+            return bigint::from_limbs(limbs(), negative);
+        }
+        
+        std::string to_string() const
+        {
+            return to_bigint().to_string();
+        }
+    };
+    
+    // 大数数组的二进制存档, 读取时把文件只读映射到内存, operator[]直接返回指向映射区的bigint_view
+    // 文件格式(小端序):
+    //   头部16字节: 魔数"IKBA", u32版本号, u64元素个数count
+    //   索引count项, 每项16字节: u64单元数据的字节偏移(从文件开头算起), u32单元数, u32标志(第0位为负号)
+    //   单元数据: 每个单元为i32, 与limbs()的格式相同
+    // 打开时只检查头部和索引, 单元的范围在to_bigint()时检查
+    class bigint_archive
+    {
+    private:
+        static constexpr char MAGIC[4] = {'I', 'K', 'B', 'A'};
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t HEADER_SIZE = 16;
+        static constexpr size_t ENTRY_SIZE = 16;
+
+        const unsigned char* base = nullptr; // 映射区的起始地址
+        size_t file_size = 0;
+        size_t count = 0;
+#ifdef _WIN32
+        HANDLE file_handle = INVALID_HANDLE_VALUE;
+        HANDLE mapping_handle = nullptr;
+#endif
+
+        [[noreturn]] static void fail(const std::string& info, const std::string& where)
+        {
+            throw_re(info, "high_precision_digit.hpp", "class bigint_archive in " + where, "ikun_bigint 013");
+            std::abort(); // 不会执行到这里
+        }
+        
+        static void check_endian(const std::string& where)
+        {
+            if constexpr (std::endian::native != std::endian::little)
+            {
+                fail("bigint_archive requires a little-endian platform", where);
+            }
+        }
+        
+        template <typename T>
+        T read_at(size_t offset) const noexcept
+        {
+            T value;
+            std::memcpy(&value, base + offset, sizeof(T));
+            return value;
+        }
+        
+        void unmap() noexcept
+        {
+#ifdef _WIN32
+            if (base != nullptr) UnmapViewOfFile(base);
+            if (mapping_handle != nullptr) CloseHandle(mapping_handle);
+            if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+            mapping_handle = nullptr;
+            file_handle = INVALID_HANDLE_VALUE;
+#else
+            if (base != nullptr) munmap(const_cast<unsigned char*>(base), file_size);
+#endif
+            base = nullptr;
+            file_size = 0;
+            count = 0;
+        }
+        
+        void map_file(const std::string& path)
+        {
+#ifdef _WIN32
+            file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_handle == INVALID_HANDLE_VALUE)
+            {
+                fail("Cannot open archive file: " + path, "constructor");
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(file_handle, &size) || size.QuadPart < static_cast<LONGLONG>(HEADER_SIZE))
+            {
+                unmap();
+                fail("Archive file is truncated: " + path, "constructor");
+            }
+            file_size = static_cast<size_t>(size.QuadPart);
+            mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            void* view = mapping_handle == nullptr ? nullptr : MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+            if (view == nullptr)
+            {
+                unmap();
+                fail("Cannot map archive file: " + path, "constructor");
+            }
+            base = static_cast<const unsigned char*>(view);
+#else
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                fail("Cannot open archive file: " + path, "constructor");
+            }
+            struct stat st;
+            if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(HEADER_SIZE))
+            {
+                close(fd);
+                fail("Archive file is truncated: " + path, "constructor");
+            }
+            file_size = static_cast<size_t>(st.st_size);
+            void* view = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd); // 映射建立后可以关闭文件描述符
+            if (view == MAP_FAILED)
+            {
+                file_size = 0;
+                fail("Cannot map archive file: " + path, "constructor");
+            }
+            base = static_cast<const unsigned char*>(view);
+#endif
+        }
+        
+        // 检查头部和索引, 保证每个元素的单元都在文件范围内并按4字节对齐
+        void validate(const std::string& path)
+        {
+            if (std::memcmp(base, MAGIC, 4) != 0 || read_at<uint32_t>(4) != VERSION)
+            {
+                fail("Not a bigint archive (bad magic or version): " + path, "constructor");
+            }
+            uint64_t n = read_at<uint64_t>(8);
+            if (n > (file_size - HEADER_SIZE) / ENTRY_SIZE)
+            {
+                fail("Archive index exceeds file size: " + path, "constructor");
+            }
+            count = static_cast<size_t>(n);
+            size_t data_begin = HEADER_SIZE + count * ENTRY_SIZE;
+            for (size_t i = 0; i < count; ++ i)
+            {
+                size_t entry = HEADER_SIZE + i * ENTRY_SIZE;
+                uint64_t offset = read_at<uint64_t>(entry);
+                uint64_t limbs = read_at<uint32_t>(entry + 8);
+                uint32_t flags = read_at<uint32_t>(entry + 12);
+                if (offset < data_begin || offset % sizeof(int) != 0 || offset > file_size ||
+                    limbs > (file_size - offset) / sizeof(int) || flags > 1)
+                {
+                    fail("Corrupted archive index entry " + std::to_string(i) + ": " + path, "constructor");
+                }
+            }
+        }
+
+    public:
+        // 只读映射path指向的存档文件, 文件格式不正确时抛出异常
+        explicit bigint_archive(const std::string& path)
+        {
+            check_endian("constructor");
+            map_file(path);
+            try
+            {
+                validate(path);
+            }
+            catch (...)
+            {
+                unmap();
+                throw;
+            }
+        }
+        
+        bigint_archive(const bigint_archive&) = delete;
+        bigint_archive& operator=(const bigint_archive&) = delete;
+        
+        bigint_archive(bigint_archive&& other) noexcept
+            : base(std::exchange(other.base, nullptr)),
+              file_size(std::exchange(other.file_size, 0)),
+              count(std::exchange(other.count, 0))
+#ifdef _WIN32
+            , file_handle(std::exchange(other.file_handle, INVALID_HANDLE_VALUE)),
+              mapping_handle(std::exchange(other.mapping_handle, nullptr))
+#endif
+        {}
+        
+        bigint_archive& operator=(bigint_archive&& other) noexcept
+        {
+            if (this != &other)
+            {
+                unmap();
+                base = std::exchange(other.base, nullptr);
+                file_size = std::exchange(other.file_size, 0);
+                count = std::exchange(other.count, 0);
+#ifdef _WIN32
+                file_handle = std::exchange(other.file_handle, INVALID_HANDLE_VALUE);
+                mapping_handle = std::exchange(other.mapping_handle, nullptr);
+#endif
+            }
+            return *this;
+        }
+        
+        ~bigint_archive()
+        {
+            unmap();
+        }
+        
+        size_t size() const noexcept
+        {
+            return count;
+        }
+        
+        // 第i个元素的视图, 在存档对象销毁前有效
+        bigint_view operator[](size_t i) const noexcept
+        {
+            size_t entry = HEADER_SIZE + i * ENTRY_SIZE;
+            const int* limbs = reinterpret_cast<const int*>(base + read_at<uint64_t>(entry));
+            return bigint_view(std::span<const int>(limbs, read_at<uint32_t>(entry + 8)), (read_at<uint32_t>(entry + 12) & 1) != 0);
+        }
+        
+        bigint_view at(size_t i) const
+        {
+            if (i >= count)
+            {
+                throw_out_of_range("bigint_archive index " + std::to_string(i) + " out of range (size " + std::to_string(count) + ")",
+                    "high_precision_digit.hpp", "class bigint_archive in at()", "ikun_bigint 014");
+            }
+            return (*this)[i];
+        }
+        
+        // 把values写入path(覆盖原文件), 之后可以用bigint_archive(path)打开
+        static void write(const std::string& path, std::span<const bigint> values)
+        {
+            check_endian("write()");
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                fail("Cannot create archive file: " + path, "write()");
+            }
+            
+            auto put = [&out](const auto& value)
+            {
+                out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            };
+            
+            out.write(MAGIC, 4);
+            put(VERSION);
+            put(static_cast<uint64_t>(values.size()));
+            
+            uint64_t offset = HEADER_SIZE + values.size() * ENTRY_SIZE;
+            for (const bigint& v : values)
+            {
+                if (v.limbs().size() > std::numeric_limits<uint32_t>::max())
+                {
+                    fail("bigint too large for archive entry", "write()");
+                }
+                put(offset);
+                put(static_cast<uint32_t>(v.limbs().size()));
+                put(static_cast<uint32_t>(v.sign() < 0 ? 1 : 0));
+                offset += v.limbs().size() * sizeof(int);
+            }
+            for (const bigint& v : values)
+            {
+                out.write(reinterpret_cast<const char*>(v.limbs().data()), v.limbs().size() * sizeof(int));
+            }
+            
+            if (!out.flush())
+            {
+                fail("Failed to write archive file: " + path, "write()");
+            }
+        }
+    };
+
+    // 估算bigint对象占用的内存
+    long long est_bigint_memory(const bigint& n)
+    {
+        // 基础对象: 40字节
+        // 每9位数字: 4字节
+        return (bigint(40) + bigint(4) * ((n + bigint(8)) / bigint(9))).to_long_long();
+    }
+
+    // 输出运算符重载
+    std::ostream& operator<<(std::ostream& os, const bigint& n)
+    {
+        os << n.to_string();
+        return os;
+    }
+
+    // 输入运算符重载
+    std::istream& operator>>(std::istream& is, bigint& n)
+    {
+        std::string s;
+        is >> s;
+        n = bigint(s);
+        return is;
+    }
+
+    // 检查字符串是否有效的大数表示
+    bool is_valid_bigint_string(const std::string& s)
+    {
+        if (s.empty()) return false;
+        
+        size_t start = 0;
+        if (s[0] == '-' || s[0] == '+')
+        {
+            if (s.size() == 1) return false;
+            start = 1;
+        }
+        
+        // 跳过前导零
+        while (start < s.size() && s[start] == '0')
+        {
+            start ++;
+        }
+        
+        // 检查剩余字符
+        for (size_t i = start; i < s.size(); ++ i)
+        {
+            if (!std::isdigit(s[i])) return false;
+        }
+        
+        return true;
+    }
+
+    // 非负整数的二进制位(低位在前), 供快速幂使用, 每次取出30位
+    std::vector<unsigned char> exponent_bits(const bigint& exp)
+    {
+        std::vector<unsigned char> bits;
+        bigint e = exp;
+        while (!e.is_zero())
+        {
+            auto [q, r] = divmod(e, 1LL << 30);
+            for (int t = 0; t < 30; ++ t)
+            {
+                bits.push_back(static_cast<unsigned char>(r >> t & 1));
+            }
+            e = std::move(q);
+        }
+        while (!bits.empty() && bits.back() == 0) bits.pop_back();
+        return bits;
+    }
+
+    // 滑动窗口快速幂: bits为指数的二进制位(低位在前), 指数为0时返回one
+    // 预先计算base的奇数次幂, 每个窗口只做一次乘法, 其余都是平方
+    // square(x)把x原地平方, multiply(x, y)把x原地乘以y; maths::window_pow传入普通乘法, mod_ctx::powmod传入Barrett模乘
+    template <typename Square, typename Multiply>
+    bigint sliding_window_pow(const bigint& base, const std::vector<unsigned char>& bits, bigint one,
+        Square square, Multiply multiply)
+    {
+        size_t len = bits.size();
+        while (len > 0 && bits[len - 1] == 0) -- len;
+        if (len == 0) return one;
+        
+        // 窗口宽度随指数位数增大
+        size_t k = len < 8 ? 1 : len < 24 ? 2 : len < 80 ? 3 : len < 240 ? 4 : len < 672 ? 5 : 6;
+        
+        // odd[i] = base^(2i + 1)
+        std::vector<bigint> odd(size_t(1) << (k - 1));
+        odd[0] = base;
+        if (odd.size() > 1)
+        {
+            bigint base2 = base;
+            square(base2);
+            for (size_t i = 1; i < odd.size(); ++ i)
+            {
+                odd[i] = odd[i - 1];
+                multiply(odd[i], base2);
+            }
+        }
+        
+        bigint result;
+        bool started = false;
+        for (size_t i = len; i -- > 0; )
+        {
+            if (bits[i] == 0)
+            {
+                square(result);
+                continue;
+            }
+            
+            // 取以第i位开头, 以1结尾, 最长k位的窗口
+            size_t j = i + 1 > k ? i + 1 - k : 0;
+            while (bits[j] == 0) ++ j;
+            size_t value = 0;
+            for (size_t t = i + 1; t -- > j; )
+            {
+                value = value << 1 | bits[t];
+            }
+            
+            if (started)
+            {
+                for (size_t t = j; t <= i; ++ t)
+                {
+                    square(result);
+                }
+                multiply(result, odd[value >> 1]);
+            }
+            else
+            {
+                result = odd[value >> 1];
+                started = true;
+            }
+            i = j;
+        }
+        return result;
+    }
+
+    // 固定模数的模运算上下文(Barrett约简)
+    // 构造时预先计算mu = floor(BASE^(2k) / N), 此后每次约简只需两次乘法, 不再做除法
+    // 单元是10^9进制, Montgomery约简需要2的幂次基数, 所以这里采用Barrett约简
+    class mod_ctx
+    {
+    public:
+        explicit mod_ctx(const bigint& modulus) : n(modulus)
+        {
+            if (n <= 0)
+            {
+                throw_inv_arg("Modulus must be positive",
+                    "high_precision_digit.hpp", "class mod_ctx in constructor", "ikun_bigint 009"
+                );
+            }
+            
+            k = n.digits.size();
+            mu = bigint::shift_limbs(bigint(1), 2 * k) / n;
+        }
+        
+        const bigint& modulus() const noexcept
+        {
+            return n;
+        }
+        
+        // 将任意整数约简到[0, N)
+        bigint reduce(const bigint& x) const
+        {
+            if (!x.is_negative && x < n) return x;
+            if (x.is_negative || x.digits.size() > 2 * k) return x % n;
+            return barrett(x);
+        }
+        
+        bigint mulmod(const bigint& a, const bigint& b) const
+        {
+            return barrett(reduce(a) * reduce(b));
+        }
+        
+        bigint sqrmod(const bigint& a) const
+        {
+            return barrett(reduce(a).square());
+        }
+        
+        // 模幂: 滑动窗口, 窗口内只有一次模乘, 其余都是模平方
+        bigint powmod(const bigint& base, const bigint& exp) const
+        {
+            if (exp.is_negative)
+            {
+                throw_re("Negative exponent",
+                    "high_precision_digit.hpp", "class mod_ctx in powmod()", "ikun_bigint 004"
+                );
+            }
+            
+            return sliding_window_pow(reduce(base), exponent_bits(exp), reduce(bigint(1)),
+                [this](bigint& x) { x = barrett(x.square()); },
+                [this](bigint& x, const bigint& y) { x = barrett(x * y); });
+        }
+        
+    private:
+        bigint n;    // 模数
+        bigint mu;   // floor(BASE^(2k) / n)
+        size_t k;    // 模数的单元数
+        
+        // Barrett约简, 要求0 <= x < BASE^(2k); 估计的商只比真实值小几
+        bigint barrett(const bigint& x) const
+        {
+            bigint q = bigint::slice(x.digits, k - 1, x.digits.size());
+            if (k > TRUNCATED_LIMIT)
+            {
+                q = bigint::slice((q * mu).digits, k + 1, 2 * k + 2);
+                bigint r = x - q * n;
+                while (r >= n) r -= n;
+                return r;
+            }
+            
+            // 商只需要q * mu的高半部分, 余数只需要x - q * n的低k + 1个单元, 两次都只算一半的单元积
+            limb_vector product;
+            multiply_columns(q.digits, mu.digits, k - 1, q.digits.size() + mu.digits.size(), product);
+            q = bigint::slice(product, k + 1, product.size());
+            multiply_columns(q.digits, n.digits, 0, k + 1, product);
+            
+            // r = (x - q * n) mod BASE^(k + 1), 真实余数小于BASE^(k + 1)
+            limb_vector r(k + 1, 0);
+            long long borrow = 0;
+            for (size_t i = 0; i <= k; ++ i)
+            {
+                long long cur = (i < x.digits.size() ? x.digits[i] : 0) - borrow - product[i];
+                borrow = cur < 0;
+                r[i] = static_cast<int>(cur + (borrow ? bigint::BASE : 0));
+            }
+            bigint result(std::move(r), false);
+            result.trim();
+            while (result >= n) result -= n;
+            return result;
+        }
+        
+        // 截断乘法只用朴素算法, 模数更大时换用完整的快速乘法
+        static const size_t TRUNCATED_LIMIT = 256;
+        
+        // 计算a * b中下标在[from, to)内的单元, 按列累加, 每16个单元积才做一次进位
+        // from之前各列的进位被舍弃, 结果最多偏小几个单位; to之后的单元不计算
+        static void multiply_columns(const limb_vector& a, const limb_vector& b, size_t from, size_t to, limb_vector& out)
+        {
+            const unsigned long long base = bigint::BASE;
+            out.assign(to, 0);
+            if (a.empty() || b.empty()) return;
+            unsigned long long carry = 0;
+            for (size_t t = from; t < to; ++ t)
+            {
+                unsigned long long acc = carry % base;
+                carry /= base;
+                size_t i = t >= b.size() ? t - b.size() + 1 : 0;
+                size_t last = std::min(t, a.size() - 1);
+                for (int count = 0; i <= last; ++ i)
+                {
+                    acc += static_cast<unsigned long long>(a[i]) * static_cast<unsigned long long>(b[t - i]);
+                    if (++ count == 16)
+                    {
+                        carry += acc / base;
+                        acc %= base;
+                        count = 0;
+                    }
+                }
+                carry += acc / base;
+                out[t] = static_cast<int>(acc % base);
+            }
+        }
+    };
+
+    // 二进制大整数: 2^64进制, 符号与绝对值分开存储, 零的绝对值为空
+    // 运算全部在二进制下进行, 没有取模BASE的开销, 并支持按位运算
+    // 只在输入输出(与十进制字符串或bigint互相转换)时做进制转换, 大数的转换采用分治算法
+    // 四则运算, 比较(包括整数在左侧), sqrt/sqrtrem, to_long_long/to_int, get_digit_count等常用接口与bigint相同, 另外支持按位运算
+    class binary_bigint
+    {
+    public:
+        using limb = unsigned long long;
+
+    private:
+        static const size_t KARATSUBA_THRESHOLD = 32;  // 较短的乘数超过该单元数时使用Karatsuba乘法
+        static const size_t CONVERT_THRESHOLD = 32;    // 超过该单元数时进制转换使用分治算法
+        static constexpr limb DECIMAL_CHUNK = 10000000000000000000ULL; // 10^19, 64位能容纳的最大10的幂
+        static const int CHUNK_DIGITS = 19;
+
+        std::vector<limb> mag;   // 绝对值, 低位在前
+        bool negative = false;   // 是否为负数
+
+        // 64位乘法, 返回低64位, 高64位写入high
+        static limb mul_wide(limb a, limb b, limb& high) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+            high = static_cast<limb>(p >> 64);
+            return static_cast<limb>(p);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            return _umul128(a, b, &high);
+#else
+            limb a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+            limb b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+            limb lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi;
+            limb mid = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+            high = a_hi * b_hi + (hi_lo >> 32) + (mid >> 32);
+            return (mid << 32) | (lo_lo & 0xFFFFFFFFULL);
+#endif
+        }
+
+        // 128位除以64位: (high, low) / d, 要求high < d, 余数写入rem
+        static limb div_wide(limb high, limb low, limb d, limb& rem) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            unsigned __int128 n = (static_cast<unsigned __int128>(high) << 64) | low;
+            rem = static_cast<limb>(n % d);
+            return static_cast<limb>(n / d);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            return _udiv128(high, low, d, &rem);
+#else
+            // 逐位的移位减法, 只在没有128位支持的平台上使用
+            limb q = 0;
+            for (int i = 0; i < 64; ++ i)
+            {
+                bool carry = (high >> 63) != 0;
+                high = (high << 1) | (low >> 63);
+                low <<= 1;
+                q <<= 1;
+                if (carry || high >= d)
+                {
+                    high -= d;
+                    q |= 1;
+                }
+            }
+            rem = high;
+            return q;
+#endif
+        }
+
+        void trim() noexcept
+        {
+            while (!mag.empty() && mag.back() == 0)
+            {
+                mag.pop_back();
+            }
+            if (mag.empty()) negative = false;
+        }
+
+        static void trim(std::vector<limb>& v) noexcept
+        {
+            while (!v.empty() && v.back() == 0)
+            {
+                v.pop_back();
+            }
+        }
+
+        // 比较两个绝对值的大小
+        static int compare_mag(const std::vector<limb>& a, const std::vector<limb>& b) noexcept
+        {
+            if (a.size() != b.size()) return a.size() > b.size() ? 1 : -1;
+            for (size_t i = a.size(); i -- > 0; )
+            {
+                if (a[i] != b[i]) return a[i] > b[i] ? 1 : -1;
+            }
+            return 0;
+        }
+
+        // a += b << (64 * shift), a需要足够长或允许扩展
+        static void add_mag(std::vector<limb>& a, const limb* b, size_t nb, size_t shift = 0)
+        {
+            if (a.size() < nb + shift) a.resize(nb + shift, 0);
+            limb carry = 0;
+            size_t i = 0;
+            for (; i < nb; ++ i)
+            {
+                limb s = a[i + shift] + carry;
+                carry = s < carry;
+                s += b[i];
+                carry += s < b[i];
+                a[i + shift] = s;
+            }
+            for (i += shift; carry && i < a.size(); ++ i)
+            {
+                carry = ++ a[i] == 0;
+            }
+            if (carry) a.push_back(1);
+        }
+
+        // a -= b << (64 * shift), 要求a >= b << (64 * shift)
+        static void sub_mag(std::vector<limb>& a, const limb* b, size_t nb, size_t shift = 0) noexcept
+        {
+            limb borrow = 0;
+            size_t i = 0;
+            for (; i < nb; ++ i)
+            {
+                limb x = a[i + shift];
+                limb d = x - b[i] - borrow;
+                borrow = (x < b[i]) || (x - b[i] < borrow);
+                a[i + shift] = d;
+            }
+            for (i += shift; borrow && i < a.size(); ++ i)
+            {
+                borrow = a[i] -- == 0;
+            }
+            trim(a);
+        }
+
+        // a = a * m + add(原地), 返回溢出的高位
+        static void mul_small_mag(std::vector<limb>& a, limb m, limb add)
+        {
+            limb carry = add;
+            for (limb& x : a)
+            {
+                limb high;
+                limb low = mul_wide(x, m, high);
+                low += carry;
+                high += low < carry;
+                x = low;
+                carry = high;
+            }
+            if (carry) a.push_back(carry);
+            trim(a);
+        }
+
+        // a /= d(原地), 返回余数
+        static limb div_small_mag(std::vector<limb>& a, limb d) noexcept
+        {
+            limb rem = 0;
+            for (size_t i = a.size(); i -- > 0; )
+            {
+                a[i] = div_wide(rem, a[i], d, rem);
+            }
+            trim(a);
+            return rem;
+        }
+
+        // 朴素乘法内核: out[0, na + nb) = a * b, out不能与a, b重叠
+        static void mul_basecase(const limb* a, size_t na, const limb* b, size_t nb, limb* out) noexcept
+        {
+            std::fill(out, out + na + nb, 0);
+            for (size_t i = 0; i < na; ++ i)
+            {
+                limb carry = 0;
+                for (size_t j = 0; j < nb; ++ j)
+                {
+                    limb high;
+                    limb low = mul_wide(a[i], b[j], high);
+                    low += carry;
+                    high += low < carry;
+                    low += out[i + j];
+                    high += low < out[i + j];
+                    out[i + j] = low;
+                    carry = high;
+                }
+                out[i + nb] = carry;
+            }
+        }
+
+        // 根据规模选择乘法算法(只处理绝对值), 较长一方远长于较短一方时分块相乘
+        static void multiply_mag(const limb* a, size_t na, const limb* b, size_t nb, std::vector<limb>& out)
+        {
+            if (na < nb)
+            {
+                std::swap(a, b);
+                std::swap(na, nb);
+            }
+            out.assign(na + nb, 0);
+            if (nb == 0)
+            {
+                out.clear();
+                return;
+            }
+
+            if (nb < KARATSUBA_THRESHOLD)
+            {
+                mul_basecase(a, na, b, nb, out.data());
+            }
+            else if (na >= 2 * nb)
+            {
+                std::vector<limb> part;
+                for (size_t from = 0; from < na; from += nb)
+                {
+                    multiply_mag(a + from, std::min(nb, na - from), b, nb, part);
+                    add_mag(out, part.data(), part.size(), from);
+                }
+            }
+            else
+            {
+                // Karatsuba: 按较长一方的一半分割, 此时较短一方的高半部分非空
+                size_t m = na / 2;
+                std::vector<limb> z0, z1, z2;
+                multiply_mag(a, m, b, m, z0);
+                multiply_mag(a + m, na - m, b + m, nb - m, z2);
+
+                std::vector<limb> sa(a, a + m), sb(b, b + m);
+                add_mag(sa, a + m, na - m);
+                add_mag(sb, b + m, nb - m);
+                multiply_mag(sa.data(), sa.size(), sb.data(), sb.size(), z1);
+                trim(z0);
+                trim(z2);
+                sub_mag(z1, z0.data(), z0.size());
+                sub_mag(z1, z2.data(), z2.size());
+
+                add_mag(out, z0.data(), z0.size());
+                add_mag(out, z1.data(), z1.size(), m);
+                add_mag(out, z2.data(), z2.size(), 2 * m);
+            }
+            trim(out);
+        }
+
+        static void multiply_mag(const std::vector<limb>& a, const std::vector<limb>& b, std::vector<limb>& out)
+        {
+            multiply_mag(a.data(), a.size(), b.data(), b.size(), out);
+        }
+
+        // 长除法(Knuth算法D): 计算|a| / |b|的商和余数, 要求b非零
+        static void divmod_mag(const std::vector<limb>& a, const std::vector<limb>& b,
+            std::vector<limb>& quotient, std::vector<limb>& remainder)
+        {
+            if (compare_mag(a, b) < 0)
+            {
+                quotient.clear();
+                remainder = a;
+                return;
+            }
+
+            size_t n = b.size();
+            if (n == 1)
+            {
+                quotient = a;
+                limb r = div_small_mag(quotient, b[0]);
+                remainder.clear();
+                if (r) remainder.push_back(r);
+                return;
+            }
+
+            // 规格化: 左移使除数最高位为1
+            int s = std::countl_zero(b.back());
+            std::vector<limb> v(n), u(a.size() + 1, 0);
+            for (size_t i = n; i -- > 0; )
+            {
+                v[i] = (b[i] << s) | (s && i > 0 ? b[i - 1] >> (64 - s) : 0);
+            }
+            for (size_t i = a.size(); i -- > 0; )
+            {
+                u[i + 1] |= s ? a[i] >> (64 - s) : 0;
+                u[i] = a[i] << s;
+            }
+
+            size_t m = a.size() - n;
+            quotient.assign(m + 1, 0);
+            for (size_t j = m + 1; j -- > 0; )
+            {
+                // 试商: 用被除数最高两个单元除以除数最高单元, 再用次高单元修正
+                limb qhat, rhat;
+                bool rhat_overflow = false;
+                if (u[j + n] >= v[n - 1])
+                {
+                    qhat = ~0ULL;
+                    rhat = u[j + n - 1] + v[n - 1];
+                    rhat_overflow = rhat < v[n - 1];
+                }
+                else
+                {
+                    qhat = div_wide(u[j + n], u[j + n - 1], v[n - 1], rhat);
+                }
+                while (!rhat_overflow)
+                {
+                    limb high;
+                    limb low = mul_wide(qhat, v[n - 2], high);
+                    if (high < rhat || (high == rhat && low <= u[j + n - 2])) break;
+                    -- qhat;
+                    rhat += v[n - 1];
+                    rhat_overflow = rhat < v[n - 1];
+                }
+
+                // u[j, j + n] -= qhat * v
+                limb carry = 0, borrow = 0;
+                for (size_t i = 0; i < n; ++ i)
+                {
+                    limb high;
+                    limb low = mul_wide(qhat, v[i], high);
+                    low += carry;
+                    high += low < carry;
+                    carry = high;
+                    limb x = u[i + j];
+                    limb d = x - low - borrow;
+                    borrow = (x < low) || (x - low < borrow);
+                    u[i + j] = d;
+                }
+                limb x = u[j + n];
+                u[j + n] = x - carry - borrow;
+                bool negative_result = (x < carry) || (x - carry < borrow);
+
+                // 试商大了1, 加回一个除数
+                if (negative_result)
+                {
+                    -- qhat;
+                    limb c = 0;
+                    for (size_t i = 0; i < n; ++ i)
+                    {
+                        limb sum = u[i + j] + c;
+                        c = sum < c;
+                        sum += v[i];
+                        c += sum < v[i];
+                        u[i + j] = sum;
+                    }
+                    u[j + n] += c;
+                }
+                quotient[j] = qhat;
+            }
+            trim(quotient);
+
+            // 余数右移还原
+            remainder.assign(n, 0);
+            for (size_t i = 0; i < n; ++ i)
+            {
+                remainder[i] = (u[i] >> s) | (s ? u[i + 1] << (64 - s) : 0);
+            }
+            trim(remainder);
+        }
+
+        // powers[k] = 10^(19 * 2^k), 用于分治进制转换; 补齐到count项
+        static void decimal_powers(std::vector<std::vector<limb>>& powers, size_t count)
+        {
+            if (powers.empty()) powers.push_back({DECIMAL_CHUNK});
+            while (powers.size() < count)
+            {
+                std::vector<limb> next;
+                multiply_mag(powers.back(), powers.back(), next);
+                powers.push_back(std::move(next));
+            }
+        }
+
+        // 将x转换为十进制追加到out, x < 10^(19 * 2^(k + 1)); pad为true时补足前导零
+        static void to_decimal(std::vector<limb> x, size_t k, const std::vector<std::vector<limb>>& powers,
+            std::string& out, bool pad)
+        {
+            // 不补零时还没有输出过非零数字, 先按x自身的大小降低k, 否则高半部分的商为0, 低半部分会带着前导零输出
+            while (!pad && k > 0 && compare_mag(x, powers[k]) < 0) -- k;
+
+            if (x.size() <= CONVERT_THRESHOLD)
+            {
+                // 每次除以10^19取出19位
+                std::string digits;
+                while (!x.empty())
+                {
+                    limb chunk = div_small_mag(x, DECIMAL_CHUNK);
+                    for (int i = 0; i < CHUNK_DIGITS; ++ i)
+                    {
+                        digits.push_back(static_cast<char>('0' + chunk % 10));
+                        chunk /= 10;
+                    }
+                }
+                while (!digits.empty() && digits.back() == '0') digits.pop_back();
+                if (pad) digits.resize((size_t(CHUNK_DIGITS) << (k + 1)), '0');
+                out.append(digits.rbegin(), digits.rend());
+                return;
+            }
+
+            // x = q * 10^(19 * 2^k) + r, 低半部分必须补足前导零
+            std::vector<limb> q, r;
+            divmod_mag(x, powers[k], q, r);
+            to_decimal(std::move(q), k - 1, powers, out, pad);
+            to_decimal(std::move(r), k - 1, powers, out, true);
+        }
+
+        // 解析[first, last)内的十进制数字, 高位部分乘以10的幂后与低位部分相加
+        static std::vector<limb> from_decimal(const char* first, const char* last,
+            std::vector<std::vector<limb>>& powers)
+        {
+            size_t len = static_cast<size_t>(last - first);
+            std::vector<limb> result;
+            if (len <= CONVERT_THRESHOLD * CHUNK_DIGITS)
+            {
+                for (const char* p = first; p < last; )
+                {
+                    size_t count = std::min<size_t>(CHUNK_DIGITS, static_cast<size_t>(last - p));
+                    limb chunk = 0, scale = 1;
+                    for (size_t i = 0; i < count; ++ i, ++ p)
+                    {
+                        if (*p < '0' || *p > '9')
+                        {
+                            throw_inv_arg("Invalid character in argument of binary_bigint constructor",
+                                "high_precision_digit.hpp", "class binary_bigint(in constructor)", "ikun_bigint 001"
+                            );
+                        }
+                        chunk = chunk * 10 + static_cast<limb>(*p - '0');
+                        scale *= 10;
+                    }
+                    mul_small_mag(result, scale, chunk);
+                }
+                return result;
+            }
+
+            // 低位部分取19 * 2^k位, k取使其最接近总长度一半的值, 两部分的长度都在总长度的1/3到2/3之间
+            size_t k = 0;
+            while ((size_t(CHUNK_DIGITS) << k) * 3 < len) ++ k;
+            if ((size_t(CHUNK_DIGITS) << k) * 3 > len * 2) -- k;
+            size_t low_len = size_t(CHUNK_DIGITS) << k;
+            decimal_powers(powers, k + 1);
+
+            std::vector<limb> high = from_decimal(first, last - low_len, powers);
+            std::vector<limb> low = from_decimal(last - low_len, last, powers);
+            multiply_mag(high, powers[k], result);
+            add_mag(result, low.data(), low.size());
+            trim(result);
+            return result;
+        }
+
+        // 带符号加法: *this += (other_negative ? -|other| : |other|)
+        void add_signed(const std::vector<limb>& other, bool other_negative)
+        {
+            if (negative == other_negative)
+            {
+                add_mag(mag, other.data(), other.size());
+            }
+            else if (compare_mag(mag, other) >= 0)
+            {
+                sub_mag(mag, other.data(), other.size());
+            }
+            else
+            {
+                std::vector<limb> result = other;
+                sub_mag(result, mag.data(), mag.size());
+                mag = std::move(result);
+                negative = other_negative;
+            }
+            trim();
+        }
+
+        // 按位运算只定义在非负数上
+        void require_non_negative(const binary_bigint& other, const char* where) const
         {
-            if (other == bigint(0))
+            if (negative || other.negative)
             {
-                throw_re("Modulo by zero",
-                    "high_precision_digit.hpp", "class bigint in operator%", "ikun_bigint 003"
+                throw_inv_arg("Bitwise operation on negative binary_bigint",
+                    "high_precision_digit.hpp", where, "ikun_bigint 011"
                 );
             }
-            
-            bigint quotient = *this / other;
-            bigint result = *this - quotient * other;
-            
-            // 确保余数非负
-            if (result.is_negative)
+        }
+
+    public:
+        // 构造函数
+        binary_bigint() = default;
+
+        binary_bigint(long long n) : negative(n < 0)
+        {
+            limb un = n < 0 ? 0ULL - static_cast<limb>(n) : static_cast<limb>(n);
+            if (un) mag.push_back(un);
+        }
+
+        binary_bigint(int n) : binary_bigint(static_cast<long long>(n)) {}
+        binary_bigint(unsigned int n) : binary_bigint(static_cast<long long>(n)) {}
+
+        binary_bigint(unsigned long long n)
+        {
+            if (n) mag.push_back(n);
+        }
+
+        // 从十进制字符串构造
+        explicit binary_bigint(const std::string& s)
+        {
+            size_t start = 0;
+            if (!s.empty() && (s[0] == '-' || s[0] == '+')) start = 1;
+            while (start < s.size() && s[start] == '0') ++ start;
+
+            std::vector<std::vector<limb>> powers;
+            mag = from_decimal(s.data() + start, s.data() + s.size(), powers);
+            negative = !s.empty() && s[0] == '-';
+            trim();
+        }
+
+        explicit binary_bigint(const char* s) : binary_bigint(std::string(s)) {}
+
+        // 与十进制大数互相转换
+        explicit binary_bigint(const bigint& n) : binary_bigint(n.to_string()) {}
+
+        bigint to_bigint() const
+        {
+            return bigint(to_string());
+        }
+
+        explicit operator bigint() const
+        {
+            return to_bigint();
+        }
+
+        // 转换为十进制字符串
+        std::string to_string() const
+        {
+            if (mag.empty()) return "0";
+
+            std::string result = negative ? "-" : "";
+            if (mag.size() == 1)
+            {
+                result += std::to_string(mag[0]);
+                return result;
+            }
+
+            // 找到最小的k使|x| < 10^(19 * 2^(k + 1))
+            std::vector<std::vector<limb>> powers;
+            decimal_powers(powers, 2);
+            while (compare_mag(mag, powers.back()) >= 0)
             {
-                result = result + other;
+                decimal_powers(powers, powers.size() + 1);
             }
-            
+            to_decimal(mag, powers.size() - 2, powers, result, false);
             return result;
         }
-        
-        bigint& operator%=(const bigint& other)
+
+        // 直接访问单元(低位在前)
+        const std::vector<limb>& limbs() const noexcept
         {
-            *this = *this % other;
+            return mag;
+        }
+
+        // 算术运算符
+        binary_bigint& operator+=(const binary_bigint& other)
+        {
+            if (this == &other) return *this <<= 1;
+            add_signed(other.mag, other.negative);
             return *this;
         }
-        
-        // 快速幂运算
-        bigint pow(int exponent) const
+
+        binary_bigint& operator-=(const binary_bigint& other)
         {
-            if (exponent < 0)
+            if (this == &other) return *this = binary_bigint();
+            add_signed(other.mag, !other.negative);
+            return *this;
+        }
+
+        binary_bigint& operator*=(const binary_bigint& other)
+        {
+            std::vector<limb> result;
+            multiply_mag(mag, other.mag, result);
+            mag = std::move(result);
+            negative = negative != other.negative;
+            trim();
+            return *this;
+        }
+
+        // 带余除法: 商向零取整, 余数与被除数同号
+        friend std::pair<binary_bigint, binary_bigint> divmod(const binary_bigint& a, const binary_bigint& b)
+        {
+            if (b.mag.empty())
             {
-                throw_re("Negative exponent not supported for integers",
-                    "high_precision_digit.hpp", "class bigint in pow()", "ikun_bigint 004"
+                throw_re("Division by zero",
+                    "high_precision_digit.hpp", "class binary_bigint in divmod()", "ikun_bigint 002"
                 );
             }
-            
-            if (exponent == 0) return bigint(1);
-            
-            bigint result(1);
-            bigint base = *this;
-            
-            while (exponent > 0)
-            {
-                if (exponent & 1)
-                {
-                    result *= base;
-                }
-                base *= base;
-                exponent >>= 1;
-            }
-            
+
+            std::pair<binary_bigint, binary_bigint> result;
+            divmod_mag(a.mag, b.mag, result.first.mag, result.second.mag);
+            result.first.negative = a.negative != b.negative;
+            result.second.negative = a.negative;
+            result.first.trim();
+            result.second.trim();
             return result;
         }
-        
-        // 比较运算符
-        bool operator==(const bigint& other) const noexcept
+
+        binary_bigint& operator/=(const binary_bigint& other)
         {
-            return is_negative == other.is_negative && digits == other.digits;
+            return *this = divmod(*this, other).first;
         }
-        
-        bool operator!=(const bigint& other) const noexcept
+
+        // 取模(结果非负)
+        binary_bigint& operator%=(const binary_bigint& other)
         {
-            return !(*this == other);
+            binary_bigint r = std::move(divmod(*this, other).second);
+            if (r.negative) r.add_signed(other.mag, false);
+            return *this = std::move(r);
         }
-        
-        bool operator<(const bigint& other) const noexcept
+
+        binary_bigint operator+(const binary_bigint& other) const
         {
-            if (is_negative != other.is_negative)
-            {
-                return is_negative;
-            }
-            
-            if (is_negative)
+            binary_bigint result = *this;
+            result += other;
+            return result;
+        }
+
+        binary_bigint operator-(const binary_bigint& other) const
+        {
+            binary_bigint result = *this;
+            result -= other;
+            return result;
+        }
+
+        binary_bigint operator*(const binary_bigint& other) const
+        {
+            binary_bigint result;
+            multiply_mag(mag, other.mag, result.mag);
+            result.negative = negative != other.negative;
+            result.trim();
+            return result;
+        }
+
+        binary_bigint operator/(const binary_bigint& other) const
+        {
+            return divmod(*this, other).first;
+        }
+
+        binary_bigint operator%(const binary_bigint& other) const
+        {
+            binary_bigint result = *this;
+            result %= other;
+            return result;
+        }
+
+        binary_bigint square() const
+        {
+            return *this * *this;
+        }
+
+        // 快速幂运算
+        binary_bigint pow(int exponent) const
+        {
+            if (exponent < 0)
             {
-                return compare_abs(other) > 0;
+                throw_re("Negative exponent not supported for integers",
+                    "high_precision_digit.hpp", "class binary_bigint in pow()", "ikun_bigint 004"
+                );
             }
-            else
+
+            binary_bigint result(1);
+            binary_bigint base = *this;
+            while (exponent > 0)
             {
-                return compare_abs(other) < 0;
+                if (exponent & 1) result *= base;
+                exponent >>= 1;
+                if (exponent > 0) base = base.square();
             }
+            return result;
         }
-        
-        bool operator<=(const bigint& other) const noexcept
+
+        binary_bigint& operator++()  // 前置++
         {
-            return *this < other || *this == other;
+            return *this += binary_bigint(1);
         }
-        
-        bool operator>(const bigint& other) const noexcept
+
+        binary_bigint operator++(int)  // 后置++
         {
-            return !(*this <= other);
+            binary_bigint temp = *this;
+            ++ *this;
+            return temp;
         }
-        
-        bool operator>=(const bigint& other) const noexcept
+
+        binary_bigint& operator--()  // 前置--
         {
-            return !(*this < other);
+            return *this -= binary_bigint(1);
         }
-        
-        // 前置和后置递增递减
-        bigint& operator++()  // 前置++
+
+        binary_bigint operator--(int)  // 后置--
         {
-            *this += bigint(1);
-            return *this;
+            binary_bigint temp = *this;
+            -- *this;
+            return temp;
         }
-        
-        bigint operator++(int)  // 后置++
+
+        // 比较运算符
+        bool operator==(const binary_bigint& other) const noexcept
         {
-            bigint temp = *this;
-            ++(*this);
-            return temp;
+            return negative == other.negative && mag == other.mag;
         }
-        
-        bigint& operator--()  // 前置--
+
+        bool operator!=(const binary_bigint& other) const noexcept
         {
-            *this -= bigint(1);
-            return *this;
+            return !(*this == other);
         }
-        
-        bigint operator--(int)  // 后置--
+
+        bool operator<(const binary_bigint& other) const noexcept
         {
-            bigint temp = *this;
-            --(*this);
-            return temp;
+            if (negative != other.negative) return negative;
+            int cmp = compare_mag(mag, other.mag);
+            return negative ? cmp > 0 : cmp < 0;
         }
-        
-        // 位运算运算符
-        bigint operator<<(int shift) const  // 左移相当于乘以2^shift
+
+        bool operator<=(const binary_bigint& other) const noexcept
         {
-            if (shift < 0) return *this >> (-shift);
-            
-            bigint result = *this;
-            for (int i = 0; i < shift; ++i)
-            {
-                result *= bigint(2);
-            }
-            return result;
+            return !(other < *this);
         }
-        
-        bigint operator>>(int shift) const  // 右移相当于除以2^shift
+
+        bool operator>(const binary_bigint& other) const noexcept
         {
-            if (shift < 0) return *this << (-shift);
-            
-            bigint result = *this;
-            for (int i = 0; i < shift; ++i)
-            {
-                result /= bigint(2);
-            }
-            return result;
+            return other < *this;
         }
-        
-        // 与整数类型的运算
-        bigint operator+(long long n) const
+
+        bool operator>=(const binary_bigint& other) const noexcept
         {
-            return *this + bigint(n);
+            return !(*this < other);
         }
-        
-        bigint operator-(long long n) const
+
+        // 友元函数, 支持整数在左侧的运算
+        friend binary_bigint operator+(long long n, const binary_bigint& b)
         {
-            return *this - bigint(n);
+            return b + binary_bigint(n);
         }
-        
-        bigint operator*(long long n) const
+
+        friend binary_bigint operator-(long long n, const binary_bigint& b)
         {
-            return *this * bigint(n);
+            return binary_bigint(n) - b;
         }
-        
-        bigint operator/(long long n) const 
+
+        friend binary_bigint operator*(long long n, const binary_bigint& b)
         {
-            return *this / bigint(n);
+            return b * binary_bigint(n);
         }
-        
-        bigint operator%(long long n) const
+
+        friend binary_bigint operator/(long long n, const binary_bigint& b)
         {
-            return *this % bigint(n);
+            return binary_bigint(n) / b;
         }
-        
-        // 友元函数，支持整数在左侧的运算
-        friend bigint operator+(long long n, const bigint& b)
+
+        friend binary_bigint operator%(long long n, const binary_bigint& b)
         {
-            return bigint(n) + b;
+            return binary_bigint(n) % b;
         }
-        
-        friend bigint operator-(long long n, const bigint& b)
+
+        friend bool operator==(long long lhs, const binary_bigint& rhs)
         {
-            return bigint(n) - b;
+            return binary_bigint(lhs) == rhs;
         }
-        
-        friend bigint operator*(long long n, const bigint& b)
+
+        friend bool operator!=(long long lhs, const binary_bigint& rhs)
         {
-            return bigint(n) * b;
+            return binary_bigint(lhs) != rhs;
         }
-        
-        friend bigint operator/(long long n, const bigint& b)
+
+        friend bool operator<(long long lhs, const binary_bigint& rhs)
         {
-            return bigint(n) / b;
+            return binary_bigint(lhs) < rhs;
         }
-        
-        friend bigint operator%(long long n, const bigint& b)
+
+        friend bool operator<=(long long lhs, const binary_bigint& rhs)
         {
-            return bigint(n) % b;
+            return binary_bigint(lhs) <= rhs;
         }
-        
-        // 数学函数
-        friend bigint abs(const bigint& n)
+
+        friend bool operator>(long long lhs, const binary_bigint& rhs)
         {
-            bigint result = n;
-            result.is_negative = false;
-            return result;
+            return binary_bigint(lhs) > rhs;
         }
-        
-        friend bigint sqrt(const bigint& n)
+
+        friend bool operator>=(long long lhs, const binary_bigint& rhs)
         {
-            if (n.is_negative)
-            {
-                throw_re("Square root of negative number",
-                    "high_precision_digit.hpp", "class bigint in sqrt()", "ikun_bigint 005"
-                );
-            }
-            
-            if (n == bigint(0) || n == bigint(1)) return n;
-            
-            bigint left(1);
-            bigint right = n;
-            bigint result(1);
-            
-            while (left <= right)
+            return binary_bigint(lhs) >= rhs;
+        }
+
+        // 移位: 按单元移动后再做单元内移位, 只需扫描一遍; 右移向零取整, 与bigint一致
+        binary_bigint& operator<<=(int shift)
+        {
+            if (shift < 0)
             {
-                bigint mid = (left + right) / 2;
-                bigint square = mid * mid;
-                
-                if (square == n) return mid;
-                
-                if (square < n)
+                // -INT_MIN会溢出, 分两次移位
+                if (shift == std::numeric_limits<int>::min())
                 {
-                    left = mid + bigint(1);
-                    result = mid;
+                    *this >>= std::numeric_limits<int>::max();
+                    return *this >>= 1;
                 }
-                else
+                return *this >>= -shift;
+            }
+            if (mag.empty()) return *this;
+
+            size_t words = static_cast<size_t>(shift) / 64;
+            int bits = shift % 64;
+            mag.insert(mag.begin(), words, 0);
+            if (bits)
+            {
+                limb carry = 0;
+                for (size_t i = words; i < mag.size(); ++ i)
                 {
-                    right = mid - bigint(1);
+                    limb next = mag[i] >> (64 - bits);
+                    mag[i] = (mag[i] << bits) | carry;
+                    carry = next;
                 }
+                if (carry) mag.push_back(carry);
             }
-            
-            return result;
+            return *this;
         }
-        
-        // 实用函数
-        size_t get_digit_count() const noexcept
+
+        binary_bigint& operator>>=(int shift)
         {
-            if (digits.empty()) return 0;
-            size_t count = (digits.size() - 1) * BASE_DIGITS;
-            int last = digits.back();
-            while (last > 0)
+            if (shift < 0)
             {
-                count ++;
-                last /= 10;
+                if (shift == std::numeric_limits<int>::min())
+                {
+                    *this <<= std::numeric_limits<int>::max();
+                    return *this <<= 1;
+                }
+                return *this <<= -shift;
             }
-            return count == 0 ? 1 : count;
+
+            size_t words = static_cast<size_t>(shift) / 64;
+            int bits = shift % 64;
+            if (words >= mag.size())
+            {
+                mag.clear();
+            }
+            else
+            {
+                mag.erase(mag.begin(), mag.begin() + static_cast<std::ptrdiff_t>(words));
+                if (bits)
+                {
+                    for (size_t i = 0; i < mag.size(); ++ i)
+                    {
+                        mag[i] = (mag[i] >> bits) | (i + 1 < mag.size() ? mag[i + 1] << (64 - bits) : 0);
+                    }
+                }
+            }
+            trim();
+            return *this;
         }
-        
-        bool is_zero() const noexcept
+
+        binary_bigint operator<<(int shift) const
         {
-            return digits.size() == 1 && digits[0] == 0;
+            binary_bigint result = *this;
+            result <<= shift;
+            return result;
         }
-        
-        bool is_odd() const noexcept
+
+        binary_bigint operator>>(int shift) const
         {
-            return (digits[0] & 1) == 1;
+            binary_bigint result = *this;
+            result >>= shift;
+            return result;
         }
-        
-        bool is_even() const noexcept
+
+        // 按位运算(只支持非负数)
+        binary_bigint operator&(const binary_bigint& other) const
         {
-            return (digits[0] & 1) == 0;
+            require_non_negative(other, "class binary_bigint in operator&");
+            binary_bigint result;
+            result.mag.resize(std::min(mag.size(), other.mag.size()));
+            for (size_t i = 0; i < result.mag.size(); ++ i)
+            {
+                result.mag[i] = mag[i] & other.mag[i];
+            }
+            result.trim();
+            return result;
         }
-        
-        // 交换函数
-        void swap(bigint& other) noexcept
+
+        binary_bigint operator|(const binary_bigint& other) const
         {
-            std::swap(digits, other.digits);
-            std::swap(is_negative, other.is_negative);
+            require_non_negative(other, "class binary_bigint in operator|");
+            binary_bigint result = mag.size() >= other.mag.size() ? *this : other;
+            const binary_bigint& shorter = mag.size() >= other.mag.size() ? other : *this;
+            for (size_t i = 0; i < shorter.mag.size(); ++ i)
+            {
+                result.mag[i] |= shorter.mag[i];
+            }
+            return result;
         }
 
-        // 获取对象占用的总内存(包括动态分配的digits数组)
-        size_t get_size() const noexcept
+        binary_bigint operator^(const binary_bigint& other) const
         {
-            // 对象自身大小(包括vector对象本身)
-            size_t total = sizeof(*this);
-            
-            // 加上digits向量动态分配的内存
-            total += digits.capacity() * sizeof(int);
-            
-            // 注意：vector内部可能有额外的管理开销，这里只是估算
-            return total;
+            require_non_negative(other, "class binary_bigint in operator^");
+            binary_bigint result = mag.size() >= other.mag.size() ? *this : other;
+            const binary_bigint& shorter = mag.size() >= other.mag.size() ? other : *this;
+            for (size_t i = 0; i < shorter.mag.size(); ++ i)
+            {
+                result.mag[i] ^= shorter.mag[i];
+            }
+            result.trim();
+            return result;
         }
-    
-        // 与整数的比较
-        friend bool operator==(long long lhs, const bigint& rhs)
+
+        // 数学函数
+        friend binary_bigint abs(const binary_bigint& n)
         {
-            return bigint(lhs) == rhs;
+            binary_bigint result = n;
+            result.negative = false;
+            return result;
         }
 
-        friend bool operator!=(long long lhs, const bigint& rhs)
+        // 整数平方根(向下取整), 从不小于真实值的2的幂开始做牛顿迭代
+        friend binary_bigint sqrt(const binary_bigint& n)
         {
-            return bigint(lhs) != rhs;
+            if (n.negative)
+            {
+                throw_re("Square root of negative number",
+                    "high_precision_digit.hpp", "class binary_bigint in sqrt()", "ikun_bigint 005"
+                );
+            }
+            if (n.mag.empty()) return n;
+
+            binary_bigint x = binary_bigint(1) << static_cast<int>((n.bit_length() + 1) / 2);
+            while (true)
+            {
+                binary_bigint y = (x + n / x) >> 1;
+                if (y >= x) break;
+                x = std::move(y);
+            }
+            return x;
         }
 
-        friend bool operator<(long long lhs, const bigint& rhs)
+        // 整数平方根及余数: 返回(s, r), 满足n == s * s + r且0 <= r <= 2s
+        friend std::pair<binary_bigint, binary_bigint> sqrtrem(const binary_bigint& n)
         {
-            return bigint(lhs) < rhs;
+            if (n.negative)
+            {
+                throw_re("Square root of negative number",
+                    "high_precision_digit.hpp", "class binary_bigint in sqrtrem()", "ikun_bigint 005"
+                );
+            }
+
+            std::pair<binary_bigint, binary_bigint> result;
+            result.first = sqrt(n);
+            result.second = n - result.first.square();
+            return result;
         }
 
-        friend bool operator<=(long long lhs, const bigint& rhs)
+        // 实用函数
+        size_t bit_length() const noexcept
         {
-            return bigint(lhs) <= rhs;
+            if (mag.empty()) return 0;
+            return mag.size() * 64 - static_cast<size_t>(std::countl_zero(mag.back()));
         }
 
-        friend bool operator>(long long lhs, const bigint& rhs)
+        bool is_zero() const noexcept
         {
-            return bigint(lhs) > rhs;
+            return mag.empty();
         }
 
-        friend bool operator>=(long long lhs, const bigint& rhs)
+        bool is_odd() const noexcept
         {
-            return bigint(lhs) >= rhs;
+            return !mag.empty() && (mag[0] & 1);
         }
 
-        // 添加类型转换运算符
-        operator std::string() const
+        bool is_even() const noexcept
         {
-            return to_string();
+            return !is_odd();
         }
 
-        // 与字符串的比较
-        bool operator==(const std::string& s) const
+        bool is_negative() const noexcept
         {
-            return *this == bigint(s);
+            return negative;
         }
 
-        bool operator!=(const std::string& s) const
+        // 十进制位数(零占一位), 不做进制转换: 先由二进制位数估计, 再与一个10的幂比较
+        size_t get_digit_count() const
         {
-            return *this != bigint(s);
+            if (mag.size() <= 1) return std::to_string(mag.empty() ? 0 : mag[0]).size();
+
+            // 2^(bit_length - 1)的十进制位数, 绝对值的位数等于它或比它多1
+            size_t count = static_cast<size_t>(static_cast<double>(bit_length() - 1) * 0.30102999566398120) + 1;
+            binary_bigint power = binary_bigint(10).pow(static_cast<int>(count));
+            if (compare_mag(mag, power.mag) >= 0) ++ count;
+            return count;
         }
 
         // 转换为整数类型
         long long to_long_long() const
         {
-            if (*this > bigint(std::numeric_limits<long long>::max()) ||
-                *this < bigint(std::numeric_limits<long long>::min()))
-                {
-                throw_out_of_range("bigint value out of long long range\n" + string(color::cyan) +
-                    "        Note: If you use the to_int() function, this error may also be triggered, because the to_int() function depends on the to_long_long() function.\n",
-                    "high_precision_digit.hpp", "class bigint in to_long_long()", "ikun_bigint 007");
-            }
-            
-            long long result = 0;
-            long long multiplier = 1;
-            
-            for (size_t i = 0; i < digits.size(); ++ i)
+            limb limit = negative ? 1ULL << 63 : static_cast<limb>(std::numeric_limits<long long>::max());
+            if (mag.size() > 1 || (!mag.empty() && mag[0] > limit))
             {
-                result += static_cast<long long>(digits[i]) * multiplier;
-                multiplier *= BASE;
+                throw_out_of_range("binary_bigint value out of long long range\n" + std::string(color::cyan) +
+                    "        Note: If you use the to_int() function, this error may also be triggered, because the to_int() function depends on the to_long_long() function.\n",
+                    "high_precision_digit.hpp", "class binary_bigint in to_long_long()", "ikun_bigint 007");
             }
-            
-            return is_negative ? -result : result;
+            if (mag.empty()) return 0;
+            return negative ? static_cast<long long>(0ULL - mag[0]) : static_cast<long long>(mag[0]);
         }
 
         int to_int() const
         {
             long long val = to_long_long();
-            if (val > std::numeric_limits<int>::max() || 
+            if (val > std::numeric_limits<int>::max() ||
                 val < std::numeric_limits<int>::min())
                 {
-                throw_out_of_range("bigint value out of int range",
-                    "high_precision_digit.hpp", "class bigint in to_int()", "ikun_bigint 008");
+                throw_out_of_range("binary_bigint value out of int range",
+                    "high_precision_digit.hpp", "class binary_bigint in to_int()", "ikun_bigint 008");
                 }
             return static_cast<int>(val);
         }
-    };
 
-    // 估算bigint对象占用的内存
-    long long est_bigint_memory(const bigint& n)
-    {
-        // 基础对象: 40字节
-        // 每9位数字: 4字节
-        return (bigint(40) + bigint(4) * ((n + bigint(8)) / bigint(9))).to_long_long();
-    }
+        void swap(binary_bigint& other) noexcept
+        {
+            mag.swap(other.mag);
+            std::swap(negative, other.negative);
+        }
+    };
 
-    // 输出运算符重载
-    std::ostream& operator<<(std::ostream& os, const bigint& n)
+    std::ostream& operator<<(std::ostream& os, const binary_bigint& n)
     {
         os << n.to_string();
         return os;
     }
 
-    // 输入运算符重载
-    std::istream& operator>>(std::istream& is, bigint& n)
+    std::istream& operator>>(std::istream& is, binary_bigint& n)
     {
         std::string s;
         is >> s;
-        n = bigint(s);
+        n = binary_bigint(s);
         return is;
     }
-
-    // 检查字符串是否有效的大数表示
-    bool is_valid_bigint_string(const std::string& s)
-    {
-        if (s.empty()) return false;
-        
-        size_t start = 0;
-        if (s[0] == '-' || s[0] == '+')
-        {
-            if (s.size() == 1) return false;
-            start = 1;
-        }
-        
-        // 跳过前导零
-        while (start < s.size() && s[start] == '0')
-        {
-            start ++;
-        }
-        
-        // 检查剩余字符
-        for (size_t i = start; i < s.size(); ++ i)
-        {
-            if (!std::isdigit(s[i])) return false;
-        }
-        
-        return true;
-    }
 }
 
 template<> // 特化std::formatter, 添加对std::format和std::print(ln)的支持
@@ -1086,10 +4989,44 @@ struct std::formatter<high_precision_digit::bigint>
     }
 };
 
+template<>
+struct std::formatter<high_precision_digit::binary_bigint>
+{
+    constexpr auto parse(std::format_parse_context& ctx)
+    {
+        return ctx.begin();
+    }
+    
+    auto format(const high_precision_digit::binary_bigint& n, std::format_context& ctx) const {
+        return std::format_to(ctx.out(), "{}", n.to_string());
+    }
+};
+
 namespace maths
 {
     using namespace high_precision_digit;
     using namespace ikun_error;
+    // 大数连乘: 每轮将相邻两项相乘, 形成平衡的乘积树, 使大乘法都在规模相近的数之间进行
+    bigint product(std::vector<bigint> factors)
+    {
+        if (factors.empty()) return bigint(1);
+        while (factors.size() > 1)
+        {
+            size_t half = factors.size() / 2;
+            for (size_t i = 0; i < half; ++ i)
+            {
+                factors[i] = factors[2 * i] * factors[2 * i + 1];
+            }
+            if (factors.size() % 2 == 1)
+            {
+                factors[half] = std::move(factors.back());
+                ++ half;
+            }
+            factors.resize(half);
+        }
+        return std::move(factors[0]);
+    }
+
     bigint big_fac(int n) // 大数阶乘
     {
         if (n < 0)
@@ -1098,15 +5035,33 @@ namespace maths
                 "high_precision_digit.hpp", "function big_fac()", "ikun_bigint 006"
             );
         }
-        bigint result(1);
+        
+        // 先把相邻的因子在64位整数内乘到接近10^18作为叶子, 再用乘积树合并
+        const unsigned long long LEAF_LIMIT = 1000000000000000000ULL;
+        std::vector<bigint> leaves;
+        unsigned long long acc = 1;
         for (int i = 2; i <= n; ++ i)
         {
-            result = result * bigint(i);
+            if (acc > LEAF_LIMIT / static_cast<unsigned long long>(i))
+            {
+                leaves.emplace_back(acc);
+                acc = 1;
+            }
+            acc *= static_cast<unsigned long long>(i);
         }
-        return result;
+        leaves.emplace_back(acc);
+        return product(std::move(leaves));
+    }
+
+    // 快速幂: bits为指数的二进制位(低位在前), 窗口扫描见sliding_window_pow
+    bigint window_pow(const bigint& base, const std::vector<unsigned char>& bits)
+    {
+        return sliding_window_pow(base, bits, bigint(1),
+            [](bigint& x) { x = x.square(); },
+            [](bigint& x, const bigint& y) { x *= y; });
     }
 
-    bigint big_pow(bigint base, int exp) // 大数幂
+    bigint big_pow(const bigint& base, int exp) // 大数幂
     {
         if (exp < 0)
         {
@@ -1114,39 +5069,257 @@ namespace maths
                 "high_precision_digit.hpp", "function big_pow()", "ikun_bigint 004"
             );
         }
-        bigint result(1);
-        for (int i = 0; i < exp; ++ i)
+        
+        std::vector<unsigned char> bits;
+        for (; exp > 0; exp >>= 1)
         {
-            result = result * base;
+            bits.push_back(static_cast<unsigned char>(exp & 1));
         }
-        return result;
+        return window_pow(base, bits);
+    }
+
+    bigint big_pow(const bigint& base, const bigint& exp) // 大数幂, 指数为大数
+    {
+        if (exp < 0)
+        {
+            throw_re("Negative exponent",
+                "high_precision_digit.hpp", "function big_pow()", "ikun_bigint 004"
+            );
+        }
+        
+        // 底数为0, 1, -1时指数可以任意大, 直接得出结果
+        if (base.is_zero()) return exp.is_zero() ? bigint(1) : bigint(0);
+        if (abs(base) == 1) return divmod(exp, 2).second == 0 ? bigint(1) : base;
+        
+        return window_pow(base, exponent_bits(exp));
     }
     // 最大公因数
     bigint gcd(const bigint& a, const bigint& b)
     {
-        if (b.is_zero()) return abs(a);
-        return gcd(b, a % b);
+        return a.gcd(b);
+    }
+
+    // 扩展欧几里得算法: 返回g = gcd(a, b)(非负), 并求出x, y使a * x + b * y = g
+    bigint exgcd(const bigint& a, const bigint& b, bigint& x, bigint& y)
+    {
+        bigint r0 = a, r1 = b;
+        bigint s0(1), s1(0), t0(0), t1(1);
+        while (!r1.is_zero())
+        {
+            auto [q, r] = divmod(r0, r1);
+            r0 = std::move(r1);
+            r1 = std::move(r);
+            bigint s = s0 - q * s1;
+            s0 = std::move(s1);
+            s1 = std::move(s);
+            bigint t = t0 - q * t1;
+            t0 = std::move(t1);
+            t1 = std::move(t);
+        }
+        if (r0 < 0)
+        {
+            r0 = 0 - r0;
+            s0 = 0 - s0;
+            t0 = 0 - t0;
+        }
+        x = std::move(s0);
+        y = std::move(t0);
+        return r0;
+    }
+
+    // 模逆元: 返回[0, m)内的x使a * x ≡ 1 (mod m)
+    bigint modinv(const bigint& a, const bigint& m)
+    {
+        if (m <= 0)
+        {
+            throw_inv_arg("Modulus must be positive",
+                "high_precision_digit.hpp", "function modinv()", "ikun_bigint 009"
+            );
+        }
+        
+        bigint x, y;
+        if (exgcd(a, m, x, y) != 1)
+        {
+            throw_re("Modular inverse does not exist",
+                "high_precision_digit.hpp", "function modinv()", "ikun_bigint 010"
+            );
+        }
+        return x % m;
     }
 
-    // 最小公倍数
+    // 最小公倍数(先除后乘, 不生成完整的a * b)
     bigint lcm(const bigint& a, const bigint& b)
     {
-        return abs(a * b) / gcd(a, b);
+        if (a.is_zero() || b.is_zero()) return bigint(0);
+        return abs(a / a.gcd(b) * b);
     }
 
-    // 判断质数
-    bigint is_prime(const bigint& n)
+    // 雅可比符号(a / n), n为正奇数, a为较小的整数
+    int jacobi(long long a, const bigint& n)
     {
-        if (n <= 1) return false;
-        if (n <= 3) return true;
-        if (n % 2 == 0 || n % 3 == 0) return false;
+        int result = 1;
+        int n_mod_8 = (n % 8).to_int();
+        if (a < 0)
+        {
+            a = -a;
+            if (n_mod_8 % 4 == 3) result = -result;
+        }
+        while (a > 0 && a % 2 == 0)
+        {
+            a /= 2;
+            if (n_mod_8 == 3 || n_mod_8 == 5) result = -result;
+        }
+        if (a == 0) return n == 1 ? result : 0;
+        
+        // 二次互反律: (a / n) = (n / a) * (-1)^((a - 1) / 2 * (n - 1) / 2), 此后都是小整数
+        if (a % 4 == 3 && n_mod_8 % 4 == 3) result = -result;
+        long long m = a;
+        a = (n % m).to_long_long();
+        while (a != 0)
+        {
+            while (a % 2 == 0)
+            {
+                a /= 2;
+                if (m % 8 == 3 || m % 8 == 5) result = -result;
+            }
+            std::swap(a, m);
+            if (a % 4 == 3 && m % 4 == 3) result = -result;
+            a %= m;
+        }
+        return m == 1 ? result : 0;
+    }
 
-        for (bigint i = 5; i * i <= n; i += 6)
+    // 以base为底的强伪素数测试(Miller-Rabin), n为ctx的模数, 要求n为大于2的奇数
+    bool miller_rabin(const mod_ctx& ctx, const bigint& base)
+    {
+        const bigint& n = ctx.modulus();
+        bigint n_minus_1 = n - 1;
+        bigint d = n_minus_1;
+        size_t s = 0;
+        while (d.is_even())
+        {
+            d /= 2;
+            ++ s;
+        }
+        
+        bigint x = ctx.powmod(base, d);
+        if (x == 1 || x == n_minus_1) return true;
+        for (size_t r = 1; r < s; ++ r)
         {
-            if (n % i == 0 || n % (i + 2) == 0) return false;
+            x = ctx.sqrmod(x);
+            if (x == n_minus_1) return true;
+            if (x == 1) return false;
         }
+        return false;
+    }
 
-        return true;
+    // 强Lucas伪素数测试, 参数按Selfridge方法A选取: D为5, -7, 9, -11, ...中第一个使(D / n) = -1的数, P = 1, Q = (1 - D) / 4
+    // 要求n为大于2的奇数且不是完全平方数
+    bool strong_lucas(const mod_ctx& ctx)
+    {
+        const bigint& n = ctx.modulus();
+        long long D = 5;
+        while (true)
+        {
+            int j = jacobi(D, n);
+            if (j == -1) break;
+            if (j == 0 && abs(n) != std::abs(D)) return false; // D与n有公因数
+            D = D > 0 ? -(D + 2) : -D + 2;
+        }
+        long long Q = (1 - D) / 4;
+        
+        // 模n下除以2
+        auto half = [&n](bigint x)
+        {
+            if (x.is_odd()) x += n;
+            x /= 2;
+            return x;
+        };
+        
+        // n + 1 = d * 2^s
+        bigint d = n + 1;
+        size_t s = 0;
+        while (d.is_even())
+        {
+            d /= 2;
+            ++ s;
+        }
+        
+        // 从U_1 = 1, V_1 = P = 1开始, 按d的二进制位倍增
+        std::vector<unsigned char> bits = exponent_bits(d);
+        bigint q = ctx.reduce(bigint(Q));
+        bigint u(1), v(1), qk = q;
+        for (size_t i = bits.size() - 1; i -- > 0; )
+        {
+            // U_2k = U_k * V_k, V_2k = V_k^2 - 2Q^k
+            u = ctx.mulmod(u, v);
+            v = ctx.sqrmod(v) - qk * 2;
+            while (v < 0) v += n;
+            qk = ctx.sqrmod(qk);
+            if (bits[i])
+            {
+                // U_(k+1) = (U_k + V_k) / 2, V_(k+1) = (D * U_k + V_k) / 2
+                bigint new_u = half(ctx.reduce(u + v));
+                v = half(ctx.reduce(u * D + v));
+                u = std::move(new_u);
+                qk = ctx.mulmod(qk, q);
+            }
+        }
+        
+        if (u.is_zero() || v.is_zero()) return true;
+        for (size_t r = 1; r < s; ++ r)
+        {
+            v = ctx.sqrmod(v) - qk * 2;
+            while (v < 0) v += n;
+            if (v.is_zero()) return true;
+            qk = ctx.sqrmod(qk);
+        }
+        return false;
+    }
+
+    // 判断质数(Baillie-PSW测试)
+    // 先用小质数试除, 再做以2为底的Miller-Rabin测试和强Lucas测试, 目前没有已知的伪素数能同时通过两者
+    bool is_prime(const bigint& n)
+    {
+        if (n < 2) return false;
+        
+        // 小于2000的质数, 按乘积不超过10^9分组, 每组只对n取一次模
+        static const std::vector<int> small_primes = []
+        {
+            std::vector<int> primes;
+            std::vector<bool> composite(2000, false);
+            for (int i = 2; i < 2000; ++ i)
+            {
+                if (composite[i]) continue;
+                primes.push_back(i);
+                for (int j = i * i; j < 2000; j += i) composite[j] = true;
+            }
+            return primes;
+        }();
+        
+        if (n < 2000) return std::binary_search(small_primes.begin(), small_primes.end(), n.to_int());
+        
+        for (size_t i = 0; i < small_primes.size(); )
+        {
+            long long group = 1;
+            size_t j = i;
+            while (j < small_primes.size() && group * small_primes[j] <= 1000000000LL)
+            {
+                group *= small_primes[j ++];
+            }
+            long long r = (n % group).to_long_long();
+            for (; i < j; ++ i)
+            {
+                if (r % small_primes[i] == 0) return false;
+            }
+        }
+        if (n < 2000 * 2000) return true;
+        
+        // 完全平方数找不到使(D / n) = -1的D, 需要提前排除
+        if (sqrtrem(n).second.is_zero()) return false;
+        
+        mod_ctx ctx(n);
+        return miller_rabin(ctx, bigint(2)) && strong_lucas(ctx);
     }
 }
 #endif
\ No newline at end of file
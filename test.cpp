@@ -144,6 +144,202 @@ void test_maths()
 }
 #endif
 
+#ifdef IKUN_HIGH_PRECISION_DIGIT_HPP
+void test_high_precision_digit()
+{
+    println("\nhigh_precision_digit.hpp测试:");
+    println("注意: 本测试有运行时计算, 时间复杂度可能较高");
+
+    // 零用空的单元表示: 默认构造, 各种方式得到的零以及被移动后的对象都应是规范的零
+    bigint zero, from_string("-000"), moved_from("123456789012345678901234567890");
+    bigint moved_to = std::move(moved_from);
+    bigint assigned(42);
+    assigned = std::move(moved_to);
+    if (!zero.is_zero() || zero.to_string() != "0" || zero.get_digit_count() != 1 || zero.sign() != 0 ||
+        !zero.limbs().empty() || zero != bigint(0) || zero != from_string || from_string.to_string() != "0" ||
+        !moved_from.is_zero() || moved_from.to_string() != "0" || !moved_to.is_zero() ||
+        assigned != bigint("123456789012345678901234567890") || bigint(5) - 5 != zero || (bigint(-3) + 3).sign() != 0)
+    {
+        println("bigint零值与移动语义测试失败");
+        return;
+    }
+    println("bigint零值与移动语义测试通过");
+
+    // 1000~20000位覆盖binary_bigint分治进制转换的多层递归
+    mt19937 gen(20260124);
+    for (int len = 1000; len <= 20000; len += 500)
+    {
+        string power = "1" + string(len - 1, '0');
+        string value(1, static_cast<char>('1' + gen() % 9));
+        for (int i = 1; i < len; ++ i) value += static_cast<char>('0' + gen() % 10);
+
+        if (binary_bigint(power).to_string() != power || binary_bigint(value).to_string() != value ||
+            binary_bigint("-" + value).to_string() != "-" + value)
+        {
+            println("binary_bigint十进制往返转换测试失败(长度{})", len);
+            return;
+        }
+    }
+    println("binary_bigint十进制往返转换测试通过");
+
+    // 较短的乘数在1024~1536个单元之间时走Toom-4乘法, 与binary_bigint的乘法结果对照
+    for (int limbs : {1100, 1300, 1536})
+    {
+        string x(1, '7'), y(1, '3');
+        for (int i = 1; i < limbs * 9; ++ i)
+        {
+            x += static_cast<char>('0' + gen() % 10);
+            y += static_cast<char>('0' + gen() % 10);
+        }
+        string z = y + y.substr(0, 5000);
+
+        if ((bigint(x) * bigint(y)).to_string() != (binary_bigint(x) * binary_bigint(y)).to_string() ||
+            (bigint(x) * bigint(z)).to_string() != (binary_bigint(x) * binary_bigint(z)).to_string() ||
+            (bigint(x) * bigint(x)).to_string() != (binary_bigint(x) * binary_bigint(x)).to_string())
+        {
+            println("bigint Toom-4乘法测试失败({}个单元)", limbs);
+            return;
+        }
+    }
+    println("bigint Toom-4乘法测试通过");
+
+    // x^2 + k (0 <= k <= 2x)的平方根为x, 余数为k
+    for (int len : {50, 2000, 20000})
+    {
+        string digits(1, static_cast<char>('1' + gen() % 9));
+        for (int i = 1; i < len; ++ i) digits += static_cast<char>('0' + gen() % 10);
+        bigint x(digits), x2 = x.square();
+
+        auto [s1, r1] = sqrtrem(x2);
+        auto [s2, r2] = sqrtrem(x2 + x * 2);
+        auto [s3, r3] = sqrtrem(x2 - 1);
+        if (s1 != x || !r1.is_zero() || s2 != x || r2 != x * 2 || s3 != x - 1 || r3 != x * 2 - 2 || sqrt(x2 + x) != x)
+        {
+            println("bigint整数平方根sqrtrem()测试失败({}位)", len);
+            return;
+        }
+    }
+    println("bigint整数平方根sqrtrem()测试通过");
+
+    // 除法向零取整; 取模结果非负(0 <= r < |b|), divmod()的余数与被除数同号; 多单元除数走Knuth D算法
+    bigint dividend("123456789123456789123456789");
+    if (dividend / 7 != bigint("17636684160493827017636684") || dividend % 7 != 1 || dividend / bigint(7) != dividend / 7 ||
+        bigint(-7) / bigint(-3) != 2 || bigint(-7) % bigint(-3) != 2 || bigint(-7) % -3 != 2 || bigint(7) % bigint(-3) != 1 ||
+        divmod(bigint(-7), bigint(-3)).second != -1 ||
+        (dividend.square() + 5) / dividend != dividend || (dividend.square() + 5) % dividend != 5)
+    {
+        println("bigint除法和取模测试失败");
+        return;
+    }
+    println("bigint除法和取模测试通过");
+
+    // 单元导入导出与二进制存档: 零, 负数, 多单元的数都要原样读回
+    println("注意: 接下来会故意触发几个错误, 输出的错误信息属于正常现象");
+    vector<bigint> values = {bigint(0), bigint(-1), bigint("-123456789012345678901234567890"), dividend.square(), 0 - dividend};
+    for (const bigint& v : values)
+    {
+        if (bigint::from_limbs(v.limbs(), v.sign() < 0) != v)
+        {
+            println("bigint单元导入导出from_limbs()测试失败");
+            return;
+        }
+    }
+    try
+    {
+        bigint::from_limbs(vector<int>{1, 1000000000}); // 单元超出[0, 10^9)
+        println("bigint单元导入导出from_limbs()测试失败(非法单元没有报错)");
+        return;
+    }
+    catch (const exception& e)
+    {
+        if (string(e.what()).find("ikun_bigint 012") == string::npos)
+        {
+            println("bigint单元导入导出from_limbs()测试失败(错误码不正确)");
+            return;
+        }
+    }
+    println("bigint单元导入导出from_limbs()测试通过");
+
+    const string archive_path = "test_archive.ikba";
+    bigint_archive::write(archive_path, values);
+    {
+        bigint_archive archive(archive_path);
+        bool same = archive.size() == values.size();
+        for (size_t i = 0; same && i < values.size(); ++ i)
+        {
+            same = archive[i].to_bigint() == values[i] && archive.at(i).is_negative() == (values[i].sign() < 0);
+        }
+        if (!same)
+        {
+            println("bigint_archive存档读写测试失败");
+            return;
+        }
+
+        try
+        {
+            archive.at(values.size());
+            println("bigint_archive存档读写测试失败(at()越界没有报错)");
+            return;
+        }
+        catch (const exception& e)
+        {
+            if (string(e.what()).find("ikun_bigint 014") == string::npos)
+            {
+                println("bigint_archive存档读写测试失败(at()越界的错误码不正确)");
+                return;
+            }
+        }
+    }
+
+    // 破坏文件头的魔数, 打开时应报错
+    {
+        fstream file(archive_path, ios::binary | ios::in | ios::out);
+        file.put('X');
+    }
+    try
+    {
+        bigint_archive archive(archive_path);
+        println("bigint_archive存档读写测试失败(损坏的文件头没有报错)");
+        return;
+    }
+    catch (const exception& e)
+    {
+        if (string(e.what()).find("ikun_bigint 013") == string::npos)
+        {
+            println("bigint_archive存档读写测试失败(损坏文件头的错误码不正确)");
+            return;
+        }
+    }
+    std::filesystem::remove(archive_path);
+    std::filesystem::remove("ikun_temp_log.txt"); // 故意触发的错误留下的日志
+    println("bigint_archive存档读写测试通过");
+
+    // Baillie-PSW质数测试: 已知质数(包括梅森质数), 以及能通过以2为底Miller-Rabin测试的强伪素数
+    for (const bigint& p : {bigint(2), bigint(1000000007), bigint("2305843009213693951"),
+        bigint("170141183460469231731687303715884105727"), bigint(2).pow(521) - 1})
+    {
+        if (!maths::is_prime(p))
+        {
+            println("bigint质数测试is_prime()失败: {}应为质数", p);
+            return;
+        }
+    }
+    for (const bigint& c : {bigint(0), bigint(1), bigint(-7), bigint(561), bigint(2047), bigint(5777), bigint(3215031751LL),
+        bigint("3825123056546413051"), bigint("318665857834031151167461"), bigint(1000000007) * bigint(1000000007),
+        bigint("2305843009213693951") * bigint("170141183460469231731687303715884105727")})
+    {
+        if (maths::is_prime(c))
+        {
+            println("bigint质数测试is_prime()失败: {}应为合数", c);
+            return;
+        }
+    }
+    println("bigint质数测试is_prime()通过");
+
+    println("高精度整数测试通过");
+}
+#endif
+
 #ifdef IKUN_RANDOM_HPP
 void test_random()
 {
@@ -173,6 +369,9 @@ int main()
 #ifdef IKUN_MATHS_HPP
     test_maths();
 #endif
+#ifdef IKUN_HIGH_PRECISION_DIGIT_HPP
+    test_high_precision_digit();
+#endif
 #ifdef IKUN_RANDOM_HPP
     test_random();
 #endif